@@ -0,0 +1,224 @@
+#include "domain.hpp"
+
+#include <mutex>
+#include <unordered_set>
+
+namespace ebr {
+
+namespace {
+
+// Ids of live domains. Only touched when a thread meets a domain for the first time,
+// on thread exit and on domain construction/destruction.
+std::mutex& RegistryMutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+std::unordered_set<uint64_t>& LiveDomains() {
+    static std::unordered_set<uint64_t> ids;
+    return ids;
+}
+
+std::atomic<uint64_t> next_domain_id{1};
+
+}  // namespace
+
+// Records the calling thread owns, one per domain it has used.
+// Keyed by domain id, since a destroyed domain's address can be reused by a new one.
+struct LocalRecords {
+    struct Entry {
+        uint64_t domain_id;
+        Domain* domain;
+        detail::ThreadRecord* record;
+    };
+
+    std::vector<Entry> entries;
+
+    ~LocalRecords() {
+        std::lock_guard guard(RegistryMutex());
+        for (const Entry& entry : entries) {
+            if (LiveDomains().contains(entry.domain_id)) {
+                entry.domain->ReleaseRecord(entry.record);
+            }
+        }
+    }
+};
+
+namespace {
+
+thread_local LocalRecords local_records;
+
+}  // namespace
+
+namespace detail {
+
+size_t RetireBucket::Free() noexcept {
+    size_t count = items.size();
+    for (const Retired& item : items) {
+        item.deleter(item.ptr);
+    }
+    items.clear();
+    return count;
+}
+
+}  // namespace detail
+
+Domain::Domain() : id_(next_domain_id.fetch_add(1, std::memory_order_relaxed)) {
+    std::lock_guard guard(RegistryMutex());
+    LiveDomains().insert(id_);
+}
+
+Domain::~Domain() {
+    {
+        std::lock_guard guard(RegistryMutex());
+        LiveDomains().erase(id_);
+    }
+    detail::ThreadRecord* record = records_.exchange(nullptr, std::memory_order_acquire);
+    while (record != nullptr) {
+        detail::ThreadRecord* next = record->next;
+        for (auto& bucket : record->buckets) {
+            bucket.Free();
+        }
+        delete record;
+        record = next;
+    }
+}
+
+Domain& Domain::Global() {
+    static Domain domain;
+    return domain;
+}
+
+void Domain::Retire(void* ptr, Deleter deleter) {
+    detail::ThreadRecord* record = LocalRecord();
+    uint64_t epoch = epoch_.load(std::memory_order_acquire);
+
+    // The bucket of this epoch slot holds objects from at least three epochs ago: all safe
+    detail::RetireBucket& bucket = record->buckets[epoch % detail::ThreadRecord::kBuckets];
+    if (bucket.epoch != epoch) {
+        record->pending.fetch_sub(bucket.Free(), std::memory_order_relaxed);
+        bucket.epoch = epoch;
+    }
+    bucket.items.push_back({ptr, deleter});
+    record->pending.fetch_add(1, std::memory_order_relaxed);
+
+    if (++record->since_collect >= kCollectPeriod) {
+        record->since_collect = 0;
+        Collect(record);
+    }
+}
+
+void Domain::Collect() {
+    Collect(LocalRecord());
+    // Objects left behind by exited threads would otherwise wait until their record is reused
+    for (auto* record = records_.load(std::memory_order_acquire); record != nullptr; record = record->next) {
+        bool expected = false;
+        if (record->pending.load(std::memory_order_relaxed) != 0 &&
+            record->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+            Collect(record);
+            record->in_use.store(false, std::memory_order_release);
+        }
+    }
+}
+
+size_t Domain::PendingCount() const noexcept {
+    size_t count = 0;
+    for (auto* record = records_.load(std::memory_order_acquire); record != nullptr; record = record->next) {
+        count += record->pending.load(std::memory_order_relaxed);
+    }
+    return count;
+}
+
+detail::ThreadRecord* Domain::LocalRecord() {
+    for (const LocalRecords::Entry& entry : local_records.entries) {
+        if (entry.domain_id == id_) {
+            return entry.record;
+        }
+    }
+    detail::ThreadRecord* record = AcquireRecord();
+    {
+        // Drop entries of domains that are gone while we are on the slow path anyway
+        std::lock_guard guard(RegistryMutex());
+        std::erase_if(local_records.entries,
+                      [](const LocalRecords::Entry& entry) { return !LiveDomains().contains(entry.domain_id); });
+    }
+    local_records.entries.push_back({id_, this, record});
+    return record;
+}
+
+// Reuses a record left by an exited thread, together with whatever it had retired
+detail::ThreadRecord* Domain::AcquireRecord() {
+    for (auto* record = records_.load(std::memory_order_acquire); record != nullptr; record = record->next) {
+        bool expected = false;
+        if (!record->in_use.load(std::memory_order_relaxed) &&
+            record->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+            return record;
+        }
+    }
+
+    auto* record = new detail::ThreadRecord();
+    record->in_use.store(true, std::memory_order_relaxed);
+    detail::ThreadRecord* head = records_.load(std::memory_order_relaxed);
+    do {
+        record->next = head;
+    } while (!records_.compare_exchange_weak(head, record, std::memory_order_release, std::memory_order_relaxed));
+    return record;
+}
+
+void Domain::ReleaseRecord(detail::ThreadRecord* record) noexcept {
+    Collect(record);
+    record->since_collect = 0;
+    record->in_use.store(false, std::memory_order_release);
+}
+
+void Domain::Enter(detail::ThreadRecord* record) noexcept {
+    if (record->nesting++ != 0) {
+        return;
+    }
+    uint64_t epoch = epoch_.load(std::memory_order_relaxed);
+    record->state.store((epoch << 1) | 1, std::memory_order_relaxed);
+    // Publish the pin before any shared node is read
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+void Domain::Leave(detail::ThreadRecord* record) noexcept {
+    if (--record->nesting == 0) {
+        record->state.store(0, std::memory_order_release);
+    }
+}
+
+// The epoch moves on only when every pinned thread has observed the current one
+bool Domain::TryAdvance() noexcept {
+    uint64_t epoch = epoch_.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    for (auto* record = records_.load(std::memory_order_acquire); record != nullptr; record = record->next) {
+        uint64_t state = record->state.load(std::memory_order_relaxed);
+        if ((state & 1) != 0 && (state >> 1) != epoch) {
+            return false;
+        }
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    // Losing the race means another thread advanced it, which is just as good
+    epoch_.compare_exchange_strong(epoch, epoch + 1, std::memory_order_release, std::memory_order_relaxed);
+    return true;
+}
+
+void Domain::Collect(detail::ThreadRecord* record) noexcept {
+    TryAdvance();
+    uint64_t epoch = epoch_.load(std::memory_order_acquire);
+    for (auto& bucket : record->buckets) {
+        if (!bucket.items.empty() && bucket.epoch + 2 <= epoch) {
+            record->pending.fetch_sub(bucket.Free(), std::memory_order_relaxed);
+        }
+    }
+}
+
+Guard::Guard(Domain& domain) : domain_(domain), record_(domain.LocalRecord()) {
+    domain_.Enter(record_);
+}
+
+Guard::~Guard() {
+    domain_.Leave(record_);
+}
+
+}  // namespace ebr
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Epoch-based memory reclamation (EBR).
+//
+// Readers of a lock-free structure enter a critical section with ebr::Guard before touching
+// shared nodes. A writer that unlinked a node hands it to Retire() instead of deleting it:
+// the node is tagged with the current global epoch and freed only once the epoch has moved
+// two steps further, which is impossible while some guard from that time is still open.
+//
+// Retired nodes sit in per-thread lists, so Retire() takes no locks; every kCollectPeriod
+// retirements the thread tries to advance the epoch and frees whole batches at once.
+namespace ebr {
+
+using Deleter = void (*)(void*);
+
+namespace detail {
+
+struct Retired {
+    void* ptr;
+    Deleter deleter;
+};
+
+// Objects retired by one thread during one epoch
+struct RetireBucket {
+    uint64_t epoch{0};
+    std::vector<Retired> items;
+
+    // Runs the deleters and returns how many objects were freed
+    size_t Free() noexcept;
+};
+
+struct alignas(64) ThreadRecord {
+    static constexpr size_t kBuckets = 3;
+
+    // (epoch << 1) | 1 while the owner is inside a guard, 0 otherwise
+    std::atomic<uint64_t> state{0};
+    std::atomic<bool> in_use{false};
+    std::atomic<size_t> pending{0};
+    ThreadRecord* next{nullptr};
+
+    // Owner-only fields
+    size_t nesting{0};
+    size_t since_collect{0};
+    RetireBucket buckets[kBuckets];
+};
+
+}  // namespace detail
+
+class Domain {
+public:
+    static constexpr size_t kCollectPeriod = 64;
+
+    Domain();
+    Domain(const Domain&) = delete;
+    Domain& operator=(const Domain&) = delete;
+
+    // Frees everything still retired. No thread may be inside a guard of this domain.
+    ~Domain();
+
+    // Process-wide domain used by containers that opt into EBR
+    static Domain& Global();
+
+    // `ptr` must already be unreachable for threads that enter a guard from now on
+    void Retire(void* ptr, Deleter deleter);
+
+    template <typename T>
+    void Retire(T* ptr) {
+        Retire(ptr, [](void* p) { delete static_cast<T*>(p); });
+    }
+
+    // Tries to advance the epoch and frees the batches that became safe: the calling thread's
+    // own and those left by exited threads
+    void Collect();
+
+    uint64_t Epoch() const noexcept {
+        return epoch_.load(std::memory_order_acquire);
+    }
+
+    // Objects retired by all threads and not freed yet; exact only while the domain is quiet
+    size_t PendingCount() const noexcept;
+
+private:
+    friend class Guard;
+    friend struct LocalRecords;
+
+    detail::ThreadRecord* LocalRecord();
+    detail::ThreadRecord* AcquireRecord();
+    void ReleaseRecord(detail::ThreadRecord* record) noexcept;
+
+    void Enter(detail::ThreadRecord* record) noexcept;
+    void Leave(detail::ThreadRecord* record) noexcept;
+
+    bool TryAdvance() noexcept;
+    void Collect(detail::ThreadRecord* record) noexcept;
+
+private:
+    std::atomic<uint64_t> epoch_{1};
+    std::atomic<detail::ThreadRecord*> records_{nullptr};
+    uint64_t id_;
+};
+
+// Critical section of the calling thread; nests freely
+class Guard {
+public:
+    explicit Guard(Domain& domain = Domain::Global());
+    Guard(const Guard&) = delete;
+    Guard& operator=(const Guard&) = delete;
+    ~Guard();
+
+private:
+    Domain& domain_;
+    detail::ThreadRecord* record_;
+};
+
+}  // namespace ebr
@@ -0,0 +1,164 @@
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <ebr/domain.hpp>
+
+// Meant to run under ASAN (cmake -DASAN=ON): a node freed too early turns into a use-after-free report.
+
+namespace {
+
+constexpr uint64_t kAlive = 0xA11CEA11CEA11CEull;
+
+std::atomic<int64_t> live_nodes{0};
+
+struct Node {
+  explicit Node(int64_t v) : value(v) {
+    live_nodes.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  ~Node() {
+    canary = 0;
+    live_nodes.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  int64_t value;
+  std::atomic<Node*> next{nullptr};
+  uint64_t canary{kAlive};
+};
+
+// Plain Treiber stack: without EBR, Pop would read `next` of a node another thread already freed
+class Stack {
+public:
+  explicit Stack(ebr::Domain& domain) : domain_(domain) {
+  }
+
+  ~Stack() {
+    for (Node* cur = head_.load(); cur != nullptr;) {
+      Node* next = cur->next.load();
+      delete cur;
+      cur = next;
+    }
+  }
+
+  void Push(int64_t value) {
+    auto* node = new Node(value);
+    Node* head = head_.load(std::memory_order_relaxed);
+    do {
+      node->next.store(head, std::memory_order_relaxed);
+    } while (!head_.compare_exchange_weak(head, node, std::memory_order_release, std::memory_order_relaxed));
+  }
+
+  bool Pop(int64_t& value) {
+    ebr::Guard guard(domain_);
+    Node* head = head_.load(std::memory_order_acquire);
+    while (head != nullptr) {
+      EXPECT_EQ(head->canary, kAlive);
+      Node* next = head->next.load(std::memory_order_relaxed);
+      if (head_.compare_exchange_weak(head, next, std::memory_order_acquire, std::memory_order_acquire)) {
+        value = head->value;
+        domain_.Retire(head);
+        return true;
+      }
+    }
+    return false;
+  }
+
+private:
+  ebr::Domain& domain_;
+  std::atomic<Node*> head_{nullptr};
+};
+
+}  // namespace
+
+TEST(EbrStressTest, TreiberStack) {
+  const int threads_count = std::max(4u, std::thread::hardware_concurrency());
+  const int64_t ops = 100'000;
+  std::atomic<int64_t> pushed_sum{0};
+  std::atomic<int64_t> popped_sum{0};
+  {
+    ebr::Domain domain;
+    {
+      Stack stack(domain);
+      std::vector<std::thread> threads;
+      for (int t = 0; t < threads_count; ++t) {
+        threads.emplace_back([&, t] {
+          int64_t local_pushed = 0;
+          int64_t local_popped = 0;
+          for (int64_t i = 0; i < ops; ++i) {
+            int64_t value = t * ops + i;
+            stack.Push(value);
+            local_pushed += value;
+            int64_t popped;
+            if (stack.Pop(popped)) {
+              local_popped += popped;
+            }
+          }
+          pushed_sum += local_pushed;
+          popped_sum += local_popped;
+        });
+      }
+      for (auto& thread : threads) {
+        thread.join();
+      }
+      int64_t rest;
+      while (stack.Pop(rest)) {
+        popped_sum += rest;
+      }
+      ASSERT_EQ(pushed_sum, popped_sum);
+      ASSERT_LT(domain.PendingCount(), static_cast<size_t>(threads_count * ops)) << "Nothing was reclaimed";
+    }
+  }
+  ASSERT_EQ(live_nodes, 0);
+}
+
+// Readers walk a list while writers keep replacing its nodes
+TEST(EbrStressTest, ReadersDuringReplacement) {
+  constexpr int kSlots = 64;
+  ebr::Domain domain;
+  std::vector<std::atomic<Node*>> slots(kSlots);
+  for (auto& slot : slots) {
+    slot.store(new Node(0));
+  }
+  std::atomic<bool> stop{false};
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 2; ++t) {
+    threads.emplace_back([&, t] {
+      for (int64_t i = 1; i <= 50'000; ++i) {
+        auto* fresh = new Node(i);
+        Node* old = slots[(i * 7 + t) % kSlots].exchange(fresh, std::memory_order_acq_rel);
+        domain.Retire(old);
+      }
+    });
+  }
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&] {
+      while (!stop.load(std::memory_order_relaxed)) {
+        ebr::Guard guard(domain);
+        for (auto& slot : slots) {
+          Node* node = slot.load(std::memory_order_acquire);
+          ASSERT_EQ(node->canary, kAlive);
+        }
+      }
+    });
+  }
+  threads[0].join();
+  threads[1].join();
+  stop = true;
+  for (size_t i = 2; i < threads.size(); ++i) {
+    threads[i].join();
+  }
+  for (auto& slot : slots) {
+    delete slot.load();
+  }
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+
+  return RUN_ALL_TESTS();
+}
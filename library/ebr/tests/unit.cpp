@@ -0,0 +1,127 @@
+#include <atomic>
+#include <future>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <ebr/domain.hpp>
+
+namespace {
+
+std::atomic<int> destroyed{0};
+
+struct Tracked {
+  ~Tracked() {
+    destroyed.fetch_add(1);
+  }
+};
+
+void CollectMany(ebr::Domain& domain) {
+  for (int i = 0; i < 8; ++i) {
+    domain.Collect();
+  }
+}
+
+}  // namespace
+
+TEST(EbrTest, FreesOnceQuiescent) {
+  destroyed = 0;
+  ebr::Domain domain;
+  {
+    ebr::Guard guard(domain);
+    domain.Retire(new Tracked());
+  }
+  ASSERT_EQ(domain.PendingCount(), 1);
+  CollectMany(domain);
+  ASSERT_EQ(destroyed, 1);
+  ASSERT_EQ(domain.PendingCount(), 0);
+}
+
+TEST(EbrTest, ReaderBlocksReclamation) {
+  destroyed = 0;
+  ebr::Domain domain;
+  std::promise<void> pinned;
+  std::promise<void> release;
+  std::thread reader([&] {
+    ebr::Guard guard(domain);
+    pinned.set_value();
+    release.get_future().wait();
+  });
+  pinned.get_future().wait();
+
+  domain.Retire(new Tracked());
+  CollectMany(domain);
+  ASSERT_EQ(destroyed, 0) << "Object freed while a reader that could see it is pinned";
+  uint64_t stuck = domain.Epoch();
+  CollectMany(domain);
+  ASSERT_LE(domain.Epoch(), stuck + 1);
+
+  release.set_value();
+  reader.join();
+  CollectMany(domain);
+  ASSERT_EQ(destroyed, 1);
+}
+
+TEST(EbrTest, NestedGuards) {
+  destroyed = 0;
+  ebr::Domain domain;
+  std::promise<void> pinned;
+  std::promise<void> release;
+  std::thread reader([&] {
+    ebr::Guard outer(domain);
+    {
+      ebr::Guard inner(domain);
+    }
+    pinned.set_value();
+    release.get_future().wait();
+  });
+  pinned.get_future().wait();
+  domain.Retire(new Tracked());
+  CollectMany(domain);
+  ASSERT_EQ(destroyed, 0) << "Leaving an inner guard unpinned the thread";
+  release.set_value();
+  reader.join();
+  CollectMany(domain);
+  ASSERT_EQ(destroyed, 1);
+}
+
+TEST(EbrTest, BatchedFreeWithoutExplicitCollect) {
+  destroyed = 0;
+  ebr::Domain domain;
+  const int count = static_cast<int>(ebr::Domain::kCollectPeriod) * 10;
+  for (int i = 0; i < count; ++i) {
+    ebr::Guard guard(domain);
+    domain.Retire(new Tracked());
+  }
+  ASSERT_GT(destroyed, 0);
+  ASSERT_LT(domain.PendingCount(), static_cast<size_t>(count));
+}
+
+TEST(EbrTest, ExitedThreadsHandOverRetiredObjects) {
+  destroyed = 0;
+  {
+    ebr::Domain domain;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+      threads.emplace_back([&] {
+        for (int i = 0; i < 10; ++i) {
+          ebr::Guard guard(domain);
+          domain.Retire(new Tracked());
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    // Picks up a record released by one of the exited threads
+    std::thread([&] { domain.Retire(new Tracked()); }).join();
+  }
+  ASSERT_EQ(destroyed, 41);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,156 @@
+#pragma once
+
+// Allocation and hardware-counter probes for the benchmarks.
+// profiling.cpp replaces the global operator new/delete of every binary that uses the counters.
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <benchmark/benchmark.h>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace profiling {
+
+// Bumped by the replaced operator new, see profiling.cpp
+extern std::atomic<size_t> allocations;
+extern std::atomic<size_t> allocated_bytes;
+
+struct AllocationSnapshot {
+    size_t count;
+    size_t bytes;
+
+    static AllocationSnapshot Take() noexcept {
+        return {allocations.load(std::memory_order_relaxed), allocated_bytes.load(std::memory_order_relaxed)};
+    }
+};
+
+// Counts allocations made between construction and Report(), and exports them per operation
+class AllocationScope {
+public:
+    AllocationScope() : start_(AllocationSnapshot::Take()) {
+    }
+
+    void Report(benchmark::State& state, double ops) const {
+        AllocationSnapshot end = AllocationSnapshot::Take();
+        state.counters["allocs_per_op"] = static_cast<double>(end.count - start_.count) / ops;
+        state.counters["bytes_per_op"] = static_cast<double>(end.bytes - start_.bytes) / ops;
+    }
+
+private:
+    AllocationSnapshot start_;
+};
+
+// Heap bytes a container of `n` elements holds, measured while `build` runs
+template <typename Build>
+double BytesPerElement(size_t n, Build build) {
+    AllocationSnapshot start = AllocationSnapshot::Take();
+    build();
+    AllocationSnapshot end = AllocationSnapshot::Take();
+    return static_cast<double>(end.bytes - start.bytes) / static_cast<double>(n);
+}
+
+// Cache misses and retired instructions through perf_event_open.
+// Containers and hardened kernels often forbid it (perf_event_paranoid), then nothing is reported.
+class PerfCounters {
+public:
+    PerfCounters() {
+#if defined(__linux__)
+        leader_ = Open(PERF_COUNT_HW_CACHE_MISSES, -1);
+        if (leader_ >= 0) {
+            instructions_ = Open(PERF_COUNT_HW_INSTRUCTIONS, leader_);
+        }
+        if (instructions_ < 0) {
+            Close();
+        }
+#endif
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    ~PerfCounters() {
+        Close();
+    }
+
+    bool IsAvailable() const noexcept {
+        return leader_ >= 0;
+    }
+
+    void Start() {
+#if defined(__linux__)
+        if (IsAvailable()) {
+            ioctl(leader_, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+            ioctl(leader_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        }
+#endif
+    }
+
+    void Stop() {
+#if defined(__linux__)
+        if (!IsAvailable()) {
+            return;
+        }
+        ioctl(leader_, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+        // PERF_FORMAT_GROUP layout: nr, then one value per event in creation order
+        uint64_t values[3] = {0, 0, 0};
+        if (read(leader_, values, sizeof(values)) == static_cast<ssize_t>(sizeof(values))) {
+            cache_misses_ += values[1];
+            instructions_count_ += values[2];
+        }
+#endif
+    }
+
+    // Exports totals normalized by `elements`, or marks the run when counters are unavailable
+    void Report(benchmark::State& state, double elements) const {
+        if (!IsAvailable()) {
+            state.SetLabel("perf_event_open unavailable");
+            return;
+        }
+        state.counters["cache_misses_per_elem"] = static_cast<double>(cache_misses_) / elements;
+        state.counters["instructions_per_elem"] = static_cast<double>(instructions_count_) / elements;
+    }
+
+private:
+#if defined(__linux__)
+    static int Open(uint64_t config, int group) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = config;
+        attr.disabled = group < 0 ? 1 : 0;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP;
+        return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, group, 0));
+    }
+#endif
+
+    void Close() noexcept {
+#if defined(__linux__)
+        if (instructions_ >= 0) {
+            close(instructions_);
+        }
+        if (leader_ >= 0) {
+            close(leader_);
+        }
+#endif
+        leader_ = instructions_ = -1;
+    }
+
+    int leader_{-1};
+    int instructions_{-1};
+    uint64_t cache_misses_{0};
+    uint64_t instructions_count_{0};
+};
+
+}  // namespace profiling
@@ -2,112 +2,507 @@
 
 #include <fmt/core.h>
 
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
 #include <cstdlib>
 #include <functional>
+#include <initializer_list>
 #include <iterator>
+#include <new>
+#include <stdexcept>
 #include <utility>
 
+#include "exceptions.hpp"
+
 template <typename T>
 class ForwardList {
 private:
     class Node {
         friend class ForwardListIterator;
         friend class ForwardList;
-        /*???*/
 
     private:
-        /*???*/
+        T value_{};
+        // log2 of the size of the chunk holding the node, 0 if the node was allocated on its own
+        uint8_t chunk_shift_{0};
+        Node* next_{nullptr};
+
+        explicit Node(const T& val, Node* next = nullptr) : value_(val), next_(next) {
+        }
+        explicit Node(T&& val, Node* next = nullptr) : value_(std::move(val)), next_(next) {
+        }
+    };
+
+    // Bulk construction carves nodes out of chunks, back to back in list order, instead of
+    // allocating them one by one. A chunk is a power-of-two block aligned to its size: a node finds
+    // its chunk by rounding its address down, and the chunk counts its live nodes. So a chunk is
+    // freed together with its last node, whichever list that node has been spliced into.
+    struct Chunk {
+        size_t live;
+    };
+
+    static constexpr size_t kChunkHeaderBytes = (sizeof(Chunk) + alignof(Node) - 1) / alignof(Node) * alignof(Node);
+    static constexpr size_t kMinChunkBytes = std::bit_ceil(std::max<size_t>(256, kChunkHeaderBytes + sizeof(Node)));
+    static constexpr size_t kMaxChunkBytes = std::max<size_t>(size_t{1} << 16, kMinChunkBytes);
+
+    // Hands out the slots of one bulk build in address order, opening a new chunk when one is full
+    class ChunkCursor {
+    public:
+        ChunkCursor() = default;
+        ChunkCursor(const ChunkCursor&) = delete;
+        ChunkCursor& operator=(const ChunkCursor&) = delete;
+
+        // A chunk whose first node failed to construct is not owned by any node
+        ~ChunkCursor() {
+            if (chunk_ != nullptr && chunk_->live == 0) {
+                FreeChunk(chunk_, shift_);
+            }
+        }
+
+        // `remaining` is the number of nodes still to come, 0 if unknown; it sizes a new chunk
+        template <typename... Args>
+        Node* Make(size_t remaining, Args&&... args) {
+            if (left_ == 0) {
+                Open(remaining);
+            }
+            Node* node = new (next_) Node(std::forward<Args>(args)...);
+            node->chunk_shift_ = shift_;
+            ++chunk_->live;
+            next_ += sizeof(Node);
+            --left_;
+            return node;
+        }
+
+    private:
+        void Open(size_t remaining) {
+            size_t bytes = next_bytes_;
+            if (remaining != 0) {
+                remaining = std::min(remaining, kMaxChunkBytes / sizeof(Node));
+                bytes = std::clamp(std::bit_ceil(kChunkHeaderBytes + remaining * sizeof(Node)), kMinChunkBytes,
+                                   kMaxChunkBytes);
+            }
+            auto* chunk = static_cast<Chunk*>(::operator new(bytes, std::align_val_t{bytes}));
+            chunk->live = 0;
+            if (chunk_ != nullptr && chunk_->live == 0) {
+                FreeChunk(chunk_, shift_);
+            }
+            chunk_ = chunk;
+            shift_ = static_cast<uint8_t>(std::countr_zero(bytes));
+            next_ = reinterpret_cast<std::byte*>(chunk) + kChunkHeaderBytes;
+            left_ = (bytes - kChunkHeaderBytes) / sizeof(Node);
+            next_bytes_ = std::min(bytes * 2, kMaxChunkBytes);
+        }
+
+        Chunk* chunk_{nullptr};
+        uint8_t shift_{0};
+        std::byte* next_{nullptr};
+        size_t left_{0};
+        size_t next_bytes_{kMinChunkBytes};
     };
 
 public:
     class ForwardListIterator {
     public:
-        /*???*/
+        // NOLINTNEXTLINE
+        using value_type = T;
+        // NOLINTNEXTLINE
+        using reference = value_type&;
+        // NOLINTNEXTLINE
+        using pointer = value_type*;
+        // NOLINTNEXTLINE
+        using difference_type = std::ptrdiff_t;
+        // NOLINTNEXTLINE
+        using iterator_category = std::forward_iterator_tag;
+
+        ForwardListIterator() : current_(nullptr) {
+        }
+
+        bool operator==(const ForwardListIterator& other) const {
+            return current_ == other.current_;
+        }
+
+        bool operator!=(const ForwardListIterator& other) const {
+            return current_ != other.current_;
+        }
+
+        reference operator*() const {
+            if (current_ == nullptr) {
+                throw std::runtime_error("Dereferencing end iterator");
+            }
+            return current_->value_;
+        }
+
+        pointer operator->() const {
+            if (current_ == nullptr) {
+                throw std::runtime_error("Dereferencing end iterator");
+            }
+            return &current_->value_;
+        }
+
+        ForwardListIterator& operator++() {
+            if (current_ != nullptr) {
+                current_ = current_->next_;
+            }
+            return *this;
+        }
+
+        ForwardListIterator operator++(int) {
+            ForwardListIterator tmp = *this;
+            ++(*this);
+            return tmp;
+        }
 
     private:
-        explicit ForwardListIterator(const Node*) {
-            // Not implemented
+        explicit ForwardListIterator(const Node* node) : current_(const_cast<Node*>(node)) {
         }
 
     private:
         Node* current_;
+
+        friend class ForwardList;
     };
 
 public:
-    ForwardList() {
-        // Not implemented
+    ForwardList() : head_(nullptr), size_(0) {
     }
 
-    explicit ForwardList(size_t /*sz*/) {
-        // Not implemented
+    explicit ForwardList(size_t sz) : head_(nullptr), size_(0) {
+        AppendDefault(sz);
     }
 
-    ForwardList(const std::initializer_list<T>& /*values*/) {
-        // Not implemented
+    template <typename It>
+        requires std::input_iterator<It>
+    ForwardList(It first, It last) : head_(nullptr), size_(0) {
+        AppendCopy(first, last);
     }
 
-    ForwardList(const ForwardList& /*other*/) {
-        // Not implemented
+    ForwardList(const std::initializer_list<T>& values) : head_(nullptr), size_(0) {
+        AppendCopy(values.begin(), values.end());
     }
 
-    ForwardList& operator=(const ForwardList& /*other*/) {
-        std::abort();  // Not implemented
+    ForwardList(const ForwardList& other) : head_(nullptr), size_(0) {
+        AppendCopy(other.Begin(), other.End());
+    }
+
+    ForwardList& operator=(const ForwardList& other) {
+        if (this != &other) {
+            Clear();
+            AppendCopy(other.Begin(), other.End());
+        }
+        return *this;
+    }
+
+    // Replaces the contents with [first, last), nodes allocated back to back
+    template <typename It>
+        requires std::input_iterator<It>
+    void Assign(It first, It last) {
+        Clear();
+        AppendCopy(first, last);
+    }
+
+    void Assign(const std::initializer_list<T>& values) {
+        Assign(values.begin(), values.end());
     }
 
     ForwardListIterator Begin() const noexcept {
-        std::abort();  // Not implemented
+        return ForwardListIterator(head_);
     }
 
     ForwardListIterator End() const noexcept {
-        std::abort();  // Not implemented
+        return ForwardListIterator(nullptr);
     }
 
     inline T& Front() const {
-        std::abort();  // Not implemented
+        if (IsEmpty()) {
+            throw ListIsEmptyException("List is empty");
+        }
+        return head_->value_;
     }
 
     inline bool IsEmpty() const noexcept {
-        std::abort();  // Not implemented
+        return size_ == 0;
     }
 
     inline size_t Size() const noexcept {
-        std::abort();  // Not implemented
+        return size_;
+    }
+
+    void Swap(ForwardList& a) {
+        std::swap(head_, a.head_);
+        std::swap(size_, a.size_);
+    }
+
+    void EraseAfter(ForwardListIterator pos) {
+        Node* at = pos.current_;
+        if (at == nullptr || at->next_ == nullptr) {
+            return;
+        }
+        Node* victim = at->next_;
+        at->next_ = victim->next_;
+        DestroyNode(victim);
+        --size_;
     }
 
-    void Swap(ForwardList& /*a*/) {
-        // Not implemented
+    void InsertAfter(ForwardListIterator pos, const T& value) {
+        Node* at = pos.current_;
+        if (at == nullptr) {
+            PushFront(value);
+            return;
+        }
+        at->next_ = new Node(value, at->next_);
+        ++size_;
+    }
+
+    // Moves every node of `other` after `pos`; End() as `pos` means the front, like InsertAfter.
+    // Nodes are relinked, not copied.
+    void SpliceAfter(ForwardListIterator pos, ForwardList& other) {
+        if (&other == this || other.IsEmpty()) {
+            return;
+        }
+        Node* first = other.head_;
+        Node* last = first;
+        while (last->next_ != nullptr) {
+            last = last->next_;
+        }
+        Node** link = pos.current_ != nullptr ? &pos.current_->next_ : &head_;
+        last->next_ = *link;
+        *link = first;
+        size_ += other.size_;
+        other.head_ = nullptr;
+        other.size_ = 0;
+    }
+
+    // Moves the single node following `before` in `other` after `pos`
+    void SpliceAfter(ForwardListIterator pos, ForwardList& other, ForwardListIterator before) {
+        Node** from = before.current_ != nullptr ? &before.current_->next_ : &other.head_;
+        Node* n = *from;
+        if (n == nullptr || n == pos.current_) {
+            return;
+        }
+        *from = n->next_;
+        --other.size_;
+
+        Node** link = pos.current_ != nullptr ? &pos.current_->next_ : &head_;
+        n->next_ = *link;
+        *link = n;
+        ++size_;
+    }
+
+    void Reverse() noexcept {
+        Node* reversed = nullptr;
+        while (head_ != nullptr) {
+            Node* next = head_->next_;
+            head_->next_ = reversed;
+            reversed = head_;
+            head_ = next;
+        }
+        head_ = reversed;
     }
 
-    void EraseAfter(ForwardListIterator /*pos*/) {
-        // Not implemented
+    // Stable merge of two sorted lists; `other` is left empty
+    template <typename Compare = std::less<T>>
+    void Merge(ForwardList& other, Compare comp = Compare()) {
+        if (&other == this) {
+            return;
+        }
+        head_ = MergeRuns(head_, other.head_, comp);
+        size_ += other.size_;
+        other.head_ = nullptr;
+        other.size_ = 0;
+    }
+
+    // Bottom-up stable merge sort over the nodes themselves. bins[i] holds a sorted run of
+    // 2^i nodes, so the auxiliary space is one pointer per bit of Size().
+    template <typename Compare = std::less<T>>
+    void Sort(Compare comp = Compare()) {
+        if (size_ < 2) {
+            return;
+        }
+        Node* bins[kSortBins] = {};
+        size_t used = 0;
+        while (head_ != nullptr) {
+            Node* carry = head_;
+            head_ = head_->next_;
+            carry->next_ = nullptr;
+
+            size_t i = 0;
+            for (; i < used && bins[i] != nullptr; ++i) {
+                carry = MergeRuns(bins[i], carry, comp);
+                bins[i] = nullptr;
+            }
+            if (i == used) {
+                ++used;
+            }
+            bins[i] = carry;
+        }
+
+        Node* sorted = nullptr;
+        for (size_t i = 0; i < used; ++i) {
+            sorted = MergeRuns(bins[i], sorted, comp);
+        }
+        head_ = sorted;
     }
 
-    void InsertAfter(ForwardListIterator /*pos*/, const T& /*value*/) {
-        // Not implemented
+    // Erases every element for which `pred` holds, returns how many were removed
+    template <typename Predicate>
+    size_t RemoveIf(Predicate pred) {
+        size_t removed = 0;
+        Node** link = &head_;
+        while (*link != nullptr) {
+            Node* cur = *link;
+            if (pred(cur->value_)) {
+                *link = cur->next_;
+                DestroyNode(cur);
+                ++removed;
+            } else {
+                link = &cur->next_;
+            }
+        }
+        size_ -= removed;
+        return removed;
     }
 
-    ForwardListIterator Find(const T& /*value*/) const {
-        std::abort();  // Not implemented
+    // Keeps only the first element of every run of equal neighbours
+    template <typename Equal = std::equal_to<T>>
+    size_t Unique(Equal eq = Equal()) {
+        size_t removed = 0;
+        for (Node* cur = head_; cur != nullptr && cur->next_ != nullptr;) {
+            Node* next = cur->next_;
+            if (eq(cur->value_, next->value_)) {
+                cur->next_ = next->next_;
+                DestroyNode(next);
+                ++removed;
+            } else {
+                cur = next;
+            }
+        }
+        size_ -= removed;
+        return removed;
+    }
+
+    ForwardListIterator Find(const T& value) const {
+        for (Node* cur = head_; cur != nullptr; cur = cur->next_) {
+            if (cur->value_ == value) {
+                return ForwardListIterator(cur);
+            }
+        }
+        return End();
     }
 
     void Clear() noexcept {
-        // Not implemented
+        while (head_ != nullptr) {
+            Node* next = head_->next_;
+            DestroyNode(head_);
+            head_ = next;
+        }
+        size_ = 0;
+    }
+
+    void PushFront(const T& value) {
+        head_ = new Node(value, head_);
+        ++size_;
     }
 
-    void PushFront(const T& /*value*/) {
-        // Not implemented
+    void PushFront(T&& value) {
+        head_ = new Node(std::move(value), head_);
+        ++size_;
     }
 
     void PopFront() {
-        // Not implemented
+        if (IsEmpty()) {
+            throw ListIsEmptyException("List is empty");
+        }
+        Node* n = head_;
+        head_ = head_->next_;
+        DestroyNode(n);
+        --size_;
     }
 
     ~ForwardList() {
-        // Not implemented
+        Clear();
+    }
+
+private:
+    static constexpr size_t kSortBins = 64;
+
+    // Merges two sorted chains; on ties nodes of `a` go first
+    template <typename Compare>
+    static Node* MergeRuns(Node* a, Node* b, Compare& comp) {
+        Node* merged = nullptr;
+        Node** tail = &merged;
+        while (a != nullptr && b != nullptr) {
+            if (comp(b->value_, a->value_)) {
+                *tail = b;
+                b = b->next_;
+            } else {
+                *tail = a;
+                a = a->next_;
+            }
+            tail = &(*tail)->next_;
+        }
+        *tail = a != nullptr ? a : b;
+        return merged;
+    }
+
+    static void FreeChunk(Chunk* chunk, uint8_t shift) noexcept {
+        ::operator delete(chunk, std::align_val_t{size_t{1} << shift});
+    }
+
+    static void DestroyNode(Node* n) noexcept {
+        uint8_t shift = n->chunk_shift_;
+        if (shift == 0) {
+            delete n;
+            return;
+        }
+        auto* chunk = reinterpret_cast<Chunk*>(reinterpret_cast<uintptr_t>(n) & ~((uintptr_t{1} << shift) - 1));
+        n->~Node();
+        if (--chunk->live == 0) {
+            FreeChunk(chunk, shift);
+        }
+    }
+
+    // Copies [first, last) to the end of an empty list, preserving order. Nodes are carved
+    // from contiguous chunk space, so list order matches address order.
+    template <typename It>
+    void AppendCopy(It first, It last) {
+        size_t remaining = 0;
+        if constexpr (std::forward_iterator<It>) {
+            remaining = static_cast<size_t>(std::distance(first, last));
+        }
+        Node** link = &head_;
+        try {
+            ChunkCursor cursor;
+            for (; first != last; ++first) {
+                *link = cursor.Make(remaining, T(*first));
+                link = &(*link)->next_;
+                ++size_;
+                remaining -= remaining != 0 ? 1 : 0;
+            }
+        } catch (...) {
+            Clear();
+            throw;
+        }
+    }
+
+    void AppendDefault(size_t count) {
+        Node** link = &head_;
+        try {
+            ChunkCursor cursor;
+            for (; size_ < count; ++size_) {
+                *link = cursor.Make(count - size_, T{});
+                link = &(*link)->next_;
+            }
+        } catch (...) {
+            Clear();
+            throw;
+        }
     }
 
 private:
-    /*???*/
+    Node* head_{nullptr};
+    size_t size_{0};
 };
 
 namespace std {
@@ -0,0 +1,218 @@
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include <ebr/domain.hpp>
+
+// Popped nodes go to an internal free list and are reused; memory returns in the destructor
+struct NodeRecycling {};
+
+// Popped nodes are retired into ebr::Domain::Global() and freed once no reader can hold them.
+// Requires linking the ebr library.
+struct EpochReclamation {};
+
+// Multi-producer/multi-consumer LIFO (Treiber stack) over ForwardList-style singly linked nodes.
+//
+// The head is a 64-bit word holding a node pointer and a 16-bit modification tag, so a
+// PopFront that raced with pop+push of the same node fails its CAS instead of corrupting
+// the list (ABA). By default popped nodes are not freed but recycled through an internal free
+// list, which keeps a racing reader of `next_` on valid memory; they are released in the
+// destructor. With EpochReclamation a PopFront runs inside an ebr::Guard and hands the node
+// to the epoch domain, so memory of a drained stack is given back while it is still in use.
+template <typename T, typename Reclamation = NodeRecycling>
+class LockFreeStack {
+private:
+    class Node {
+        friend class LockFreeStack;
+
+        std::atomic<Node*> next_{nullptr};
+        alignas(T) unsigned char storage_[sizeof(T)];
+
+        T* Value() noexcept {
+            return std::launder(reinterpret_cast<T*>(storage_));
+        }
+    };
+
+    static_assert(std::is_same_v<Reclamation, NodeRecycling> || std::is_same_v<Reclamation, EpochReclamation>,
+                  "Unknown reclamation policy");
+    // The tag takes the top 16 bits, so node addresses must fit in 48 bits: true with 4-level
+    // paging, but not for the upper half of a 5-level (LA57) address space
+    static_assert(sizeof(void*) == 8, "Tagged pointers need 64-bit addresses");
+
+    static constexpr bool kUsesEpochs = std::is_same_v<Reclamation, EpochReclamation>;
+
+    static constexpr int kTagShift = 48;
+    static constexpr uint64_t kPointerMask = (uint64_t{1} << kTagShift) - 1;
+
+    static uint64_t Pack(Node* node, uint64_t tag) noexcept {
+        assert((reinterpret_cast<uintptr_t>(node) >> kTagShift) == 0);
+        return (reinterpret_cast<uintptr_t>(node) & kPointerMask) | (tag << kTagShift);
+    }
+
+    static Node* Pointer(uint64_t word) noexcept {
+        return reinterpret_cast<Node*>(word & kPointerMask);
+    }
+
+    static uint64_t NextTag(uint64_t word) noexcept {
+        return (word >> kTagShift) + 1;
+    }
+
+    // Treiber stack of raw nodes, used both for the values and for the recycled nodes
+    class TaggedHead {
+    public:
+        void Push(Node* first, Node* last) noexcept {
+            uint64_t head = word_.load(std::memory_order_relaxed);
+            do {
+                last->next_.store(Pointer(head), std::memory_order_relaxed);
+            } while (!word_.compare_exchange_weak(head, Pack(first, NextTag(head)), std::memory_order_release,
+                                                  std::memory_order_relaxed));
+        }
+
+        Node* Pop() noexcept {
+            uint64_t head = word_.load(std::memory_order_acquire);
+            while (Pointer(head) != nullptr) {
+                Node* next = Pointer(head)->next_.load(std::memory_order_relaxed);
+                if (word_.compare_exchange_weak(head, Pack(next, NextTag(head)), std::memory_order_acquire,
+                                                std::memory_order_acquire)) {
+                    return Pointer(head);
+                }
+            }
+            return nullptr;
+        }
+
+        // Detaches the whole chain; only safe once no other thread touches the stack
+        Node* Release() noexcept {
+            return Pointer(word_.exchange(0, std::memory_order_acquire));
+        }
+
+        bool IsEmpty() const noexcept {
+            return Pointer(word_.load(std::memory_order_acquire)) == nullptr;
+        }
+
+    private:
+        std::atomic<uint64_t> word_{0};
+    };
+
+public:
+    LockFreeStack() = default;
+    LockFreeStack(const LockFreeStack&) = delete;
+    LockFreeStack& operator=(const LockFreeStack&) = delete;
+
+    ~LockFreeStack() {
+        for (Node* cur = items_.Release(); cur != nullptr;) {
+            Node* next = cur->next_.load(std::memory_order_relaxed);
+            cur->Value()->~T();
+            delete cur;
+            cur = next;
+        }
+        for (Node* cur = free_.Release(); cur != nullptr;) {
+            Node* next = cur->next_.load(std::memory_order_relaxed);
+            delete cur;
+            cur = next;
+        }
+    }
+
+    void PushFront(const T& value) {
+        Node* node = Construct(value);
+        size_.fetch_add(1, std::memory_order_relaxed);
+        items_.Push(node, node);
+    }
+
+    void PushFront(T&& value) {
+        Node* node = Construct(std::move(value));
+        size_.fetch_add(1, std::memory_order_relaxed);
+        items_.Push(node, node);
+    }
+
+    // Links the whole range with a single CAS. The result is the same as calling
+    // PushFront for each element in order: *std::prev(last) ends up on top.
+    template <typename It>
+    void PushFront(It first, It last) {
+        if (first == last) {
+            return;
+        }
+        Node* bottom = Construct(*first);
+        Node* top = bottom;
+        size_t count = 1;
+        try {
+            for (++first; first != last; ++first, ++count) {
+                Node* node = Construct(*first);
+                node->next_.store(top, std::memory_order_relaxed);
+                top = node;
+            }
+        } catch (...) {
+            for (Node* cur = top; cur != nullptr; cur = cur->next_.load(std::memory_order_relaxed)) {
+                cur->Value()->~T();
+            }
+            free_.Push(top, bottom);
+            throw;
+        }
+        size_.fetch_add(count, std::memory_order_relaxed);
+        items_.Push(top, bottom);
+    }
+
+    std::optional<T> PopFront() {
+        if constexpr (kUsesEpochs) {
+            ebr::Guard guard;
+            return PopNode();
+        } else {
+            return PopNode();
+        }
+    }
+
+    bool IsEmpty() const noexcept {
+        return items_.IsEmpty();
+    }
+
+    // Counted before a push is linked and after a pop is unlinked, so it never underflows;
+    // exact only while no operations are in flight
+    size_t Size() const noexcept {
+        return size_.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::optional<T> PopNode() {
+        Node* node = items_.Pop();
+        if (node == nullptr) {
+            return std::nullopt;
+        }
+        size_.fetch_sub(1, std::memory_order_relaxed);
+        std::optional<T> value(std::move(*node->Value()));
+        node->Value()->~T();
+        if constexpr (kUsesEpochs) {
+            ebr::Domain::Global().Retire(node);
+        } else {
+            free_.Push(node, node);
+        }
+        return value;
+    }
+
+    template <typename V>
+    Node* Construct(V&& value) {
+        Node* node = kUsesEpochs ? nullptr : free_.Pop();
+        if (node == nullptr) {
+            node = new Node();
+        }
+        try {
+            new (node->storage_) T(std::forward<V>(value));
+        } catch (...) {
+            free_.Push(node, node);
+            throw;
+        }
+        node->next_.store(nullptr, std::memory_order_relaxed);
+        return node;
+    }
+
+private:
+    TaggedHead items_;
+    TaggedHead free_;
+    std::atomic<size_t> size_{0};
+};
@@ -1,11 +1,18 @@
+#include <algorithm>
 #include <random>
 #include <forward_list>
+#include <mutex>
+#include <numeric>
 #include <string>
+#include <type_traits>
+#include <vector>
 
 #include <benchmark/benchmark.h>
 #include <fmt/core.h>
+#include <profiling/profiling.hpp>
 
 #include "../forward_list.hpp"
+#include "../lock_free_stack.hpp"
 
 void ConstructRandomList(ForwardList<int>& list, int sz) {
   std::random_device rd;
@@ -34,17 +41,31 @@ void ConstructRandomList(std::forward_list<int>& list, int sz) {
 ////////////////////////////////////////////////////////////////////////////////
 void BM_CustomListPushFront(benchmark::State& state) {
   ForwardList<int> list;
+  profiling::AllocationScope allocs;
   for (auto _ : state) {
     ConstructRandomList(list, state.range(0));
   }
+  allocs.Report(state, state.iterations() * state.range(0));
+  state.counters["bytes_per_elem"] = profiling::BytesPerElement(state.range(0), [&] {
+    ForwardList<int> fresh;
+    ConstructRandomList(fresh, state.range(0));
+    benchmark::DoNotOptimize(fresh);
+  });
   state.SetComplexityN(state.range(0));
 }
 
 void BM_StdListPushFront(benchmark::State& state) {
   std::forward_list<int> list;
+  profiling::AllocationScope allocs;
   for (auto _ : state) {
     ConstructRandomList(list, state.range(0));
   }
+  allocs.Report(state, state.iterations() * state.range(0));
+  state.counters["bytes_per_elem"] = profiling::BytesPerElement(state.range(0), [&] {
+    std::forward_list<int> fresh;
+    ConstructRandomList(fresh, state.range(0));
+    benchmark::DoNotOptimize(fresh);
+  });
   state.SetComplexityN(state.range(0));
 }
 
@@ -53,11 +74,13 @@ void BM_CustomListMiddleInsert(benchmark::State& state) {
   ConstructRandomList(list, 100);
   auto it = list.Begin();
   std::advance(it, 50);
+  profiling::AllocationScope allocs;
   for (auto _ : state) {
     for (int i = 0; i < state.range(0); ++i){
       list.InsertAfter(it, 50);
     }
   }
+  allocs.Report(state, state.iterations() * state.range(0));
   state.SetComplexityN(state.range(0));
 }
 
@@ -66,51 +89,61 @@ void BM_StdListMiddleInsert(benchmark::State& state) {
   ConstructRandomList(list, 100);
   auto it = list.begin();
   std::advance(it, 50);
+  profiling::AllocationScope allocs;
   for (auto _ : state) {
     for (int i = 0; i < state.range(0); ++i){
       list.insert_after(it, 50);
     }
   }
+  allocs.Report(state, state.iterations() * state.range(0));
   state.SetComplexityN(state.range(0));
 }
 
 void BM_CustomListErase(benchmark::State& state) {
   ForwardList<int> list;
+  profiling::AllocationScope allocs;
   for (auto _ : state) {
     ConstructRandomList(list, state.range(0));
     for (int64_t i = 0; i < state.range(0) - 1; ++i) {
       list.EraseAfter(list.Begin());
     }
   }
+  allocs.Report(state, state.iterations() * state.range(0));
   state.SetComplexityN(state.range(0));
 }
 
 void BM_StdListErase(benchmark::State& state) {
   std::forward_list<int> list;
+  profiling::AllocationScope allocs;
   for (auto _ : state) {
     ConstructRandomList(list, state.range(0));
     for (int64_t i = 0; i < state.range(0) - 1; ++i) {
       list.erase_after(list.begin());
     }
   }
+  allocs.Report(state, state.iterations() * state.range(0));
   state.SetComplexityN(state.range(0));
 }
 
 void BM_CustomListClear(benchmark::State& state) {
   ForwardList<int> list;
+  profiling::AllocationScope allocs;
   for (auto _ : state) {
     ConstructRandomList(list, state.range(0));
     list.Clear();
   }
+  allocs.Report(state, state.iterations() * state.range(0));
   state.SetComplexityN(state.range(0));
 }
 
 void BM_StdListClear(benchmark::State& state) {
   std::forward_list<int> list;
+  profiling::AllocationScope allocs;
   for (auto _ : state) {
     ConstructRandomList(list, state.range(0));
     list.clear();
   }
+  allocs.Report(state, state.iterations() * state.range(0));
   state.SetComplexityN(state.range(0));
 }
 
@@ -142,6 +175,269 @@ void BM_StdListFind(benchmark::State& state) {
   state.SetComplexityN(state.range(0));
 }
 
+// Builds 0..sz-1, then erases `sz` random nodes and re-inserts each after a random position.
+// slots[v] is the iterator of the node holding v, which lets EraseAfter find its victim's slot.
+void ConstructChurnedList(ForwardList<int>& list, int sz) {
+  std::vector<ForwardList<int>::ForwardListIterator> slots(sz);
+  for (int i = sz - 1; i >= 0; --i) {
+    list.PushFront(i);
+    slots[i] = list.Begin();
+  }
+  std::mt19937 mt(42);
+  std::uniform_int_distribution<int> dist(0, sz - 1);
+  for (int op = 0; op < sz; ++op) {
+    auto pred = slots[dist(mt)];
+    auto victim = std::next(pred);
+    if (victim == list.End()) {
+      continue;
+    }
+    int value = *victim;
+    list.EraseAfter(pred);
+    int pos = dist(mt);
+    if (pos == value) {
+      pos = *pred;
+    }
+    list.InsertAfter(slots[pos], value);
+    slots[value] = std::next(slots[pos]);
+  }
+}
+
+void ConstructChurnedList(std::forward_list<int>& list, int sz) {
+  std::vector<std::forward_list<int>::iterator> slots(sz);
+  for (int i = sz - 1; i >= 0; --i) {
+    list.push_front(i);
+    slots[i] = list.begin();
+  }
+  std::mt19937 mt(42);
+  std::uniform_int_distribution<int> dist(0, sz - 1);
+  for (int op = 0; op < sz; ++op) {
+    auto pred = slots[dist(mt)];
+    auto victim = std::next(pred);
+    if (victim == list.end()) {
+      continue;
+    }
+    int value = *victim;
+    list.erase_after(pred);
+    int pos = dist(mt);
+    if (pos == value) {
+      pos = *pred;
+    }
+    slots[value] = list.insert_after(slots[pos], value);
+  }
+}
+
+template <typename It>
+int64_t Traverse(It first, It last) {
+  int64_t sum = 0;
+  for (; first != last; ++first) {
+    sum += *first;
+  }
+  return sum;
+}
+
+template <typename ListType, typename Build>
+void RunTraversal(benchmark::State& state, Build build) {
+  ListType list;
+  build(list, state.range(0));
+  profiling::PerfCounters perf;
+  perf.Start();
+  for (auto _ : state) {
+    if constexpr (std::is_same_v<ListType, ForwardList<int>>) {
+      benchmark::DoNotOptimize(Traverse(list.Begin(), list.End()));
+    } else {
+      benchmark::DoNotOptimize(Traverse(list.begin(), list.end()));
+    }
+  }
+  perf.Stop();
+  perf.Report(state, static_cast<double>(state.iterations() * state.range(0)));
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetComplexityN(state.range(0));
+}
+
+void BM_CustomListTraverse(benchmark::State& state) {
+  RunTraversal<ForwardList<int>>(state, [](ForwardList<int>& list, int sz) { ConstructRandomList(list, sz); });
+}
+
+void BM_StdListTraverse(benchmark::State& state) {
+  RunTraversal<std::forward_list<int>>(state,
+                                       [](std::forward_list<int>& list, int sz) { ConstructRandomList(list, sz); });
+}
+
+void BM_CustomListTraverseChurned(benchmark::State& state) {
+  RunTraversal<ForwardList<int>>(state, [](ForwardList<int>& list, int sz) { ConstructChurnedList(list, sz); });
+}
+
+void BM_StdListTraverseChurned(benchmark::State& state) {
+  RunTraversal<std::forward_list<int>>(state,
+                                       [](std::forward_list<int>& list, int sz) { ConstructChurnedList(list, sz); });
+}
+
+void BM_CustomListSort(benchmark::State& state) {
+  for (auto _ : state) {
+    state.PauseTiming();
+    ForwardList<int> list;
+    ConstructRandomList(list, state.range(0));
+    state.ResumeTiming();
+    list.Sort();
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+// What the pipeline did before ForwardList::Sort: copy out, sort, rebuild
+void BM_CustomListSortViaVector(benchmark::State& state) {
+  for (auto _ : state) {
+    state.PauseTiming();
+    ForwardList<int> list;
+    ConstructRandomList(list, state.range(0));
+    state.ResumeTiming();
+    std::vector<int> values;
+    values.reserve(list.Size());
+    for (auto it = list.Begin(); it != list.End(); ++it) {
+      values.push_back(*it);
+    }
+    std::stable_sort(values.begin(), values.end());
+    list.Clear();
+    for (auto it = values.rbegin(); it != values.rend(); ++it) {
+      list.PushFront(*it);
+    }
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+void BM_StdListSort(benchmark::State& state) {
+  for (auto _ : state) {
+    state.PauseTiming();
+    std::forward_list<int> list;
+    ConstructRandomList(list, state.range(0));
+    state.ResumeTiming();
+    list.sort();
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+std::vector<int> RandomValues(int sz) {
+  std::mt19937 mt(7);
+  std::uniform_int_distribution<int> dist(INT_MIN, INT_MAX);
+  std::vector<int> values(sz);
+  for (auto& v : values) {
+    v = dist(mt);
+  }
+  return values;
+}
+
+// Bulk path: the whole range lands in a few contiguous chunks
+void BM_CustomListRangeConstruct(benchmark::State& state) {
+  std::vector<int> values = RandomValues(state.range(0));
+  profiling::AllocationScope allocs;
+  for (auto _ : state) {
+    ForwardList<int> list(values.begin(), values.end());
+    benchmark::DoNotOptimize(list);
+  }
+  allocs.Report(state, state.iterations() * state.range(0));
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetComplexityN(state.range(0));
+}
+
+// Per-node path building the same order
+void BM_CustomListPushFrontConstruct(benchmark::State& state) {
+  std::vector<int> values = RandomValues(state.range(0));
+  profiling::AllocationScope allocs;
+  for (auto _ : state) {
+    ForwardList<int> list;
+    for (auto it = values.rbegin(); it != values.rend(); ++it) {
+      list.PushFront(*it);
+    }
+    benchmark::DoNotOptimize(list);
+  }
+  allocs.Report(state, state.iterations() * state.range(0));
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetComplexityN(state.range(0));
+}
+
+void BM_StdListRangeConstruct(benchmark::State& state) {
+  std::vector<int> values = RandomValues(state.range(0));
+  profiling::AllocationScope allocs;
+  for (auto _ : state) {
+    std::forward_list<int> list(values.begin(), values.end());
+    benchmark::DoNotOptimize(list);
+  }
+  allocs.Report(state, state.iterations() * state.range(0));
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetComplexityN(state.range(0));
+}
+
+void BM_CustomListTraverseBulk(benchmark::State& state) {
+  RunTraversal<ForwardList<int>>(state, [](ForwardList<int>& list, int sz) {
+    std::vector<int> values = RandomValues(sz);
+    list.Assign(values.begin(), values.end());
+  });
+}
+
+void BM_StdListTraverseBulk(benchmark::State& state) {
+  RunTraversal<std::forward_list<int>>(state, [](std::forward_list<int>& list, int sz) {
+    std::vector<int> values = RandomValues(sz);
+    list.assign(values.begin(), values.end());
+  });
+}
+
+// Shared by all benchmark threads: every thread runs push/pop pairs against the same stack
+constexpr int kStackOpsPerIteration = 1 << 10;
+
+void BM_LockFreeStackPushPop(benchmark::State& state) {
+  static LockFreeStack<int> stack;
+  for (auto _ : state) {
+    for (int i = 0; i < kStackOpsPerIteration; ++i) {
+      stack.PushFront(i);
+      benchmark::DoNotOptimize(stack.PopFront());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kStackOpsPerIteration * 2);
+}
+
+// Nodes are freed through epoch-based reclamation instead of being recycled
+void BM_LockFreeStackEbrPushPop(benchmark::State& state) {
+  static LockFreeStack<int, EpochReclamation> stack;
+  for (auto _ : state) {
+    for (int i = 0; i < kStackOpsPerIteration; ++i) {
+      stack.PushFront(i);
+      benchmark::DoNotOptimize(stack.PopFront());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kStackOpsPerIteration * 2);
+}
+
+void BM_MutexForwardListPushPop(benchmark::State& state) {
+  static ForwardList<int> list;
+  static std::mutex mutex;
+  for (auto _ : state) {
+    for (int i = 0; i < kStackOpsPerIteration; ++i) {
+      {
+        std::lock_guard guard(mutex);
+        list.PushFront(i);
+      }
+      std::lock_guard guard(mutex);
+      if (!list.IsEmpty()) {
+        benchmark::DoNotOptimize(list.Front());
+        list.PopFront();
+      }
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kStackOpsPerIteration * 2);
+}
+
+void BM_LockFreeStackBatchPush(benchmark::State& state) {
+  static LockFreeStack<int> stack;
+  std::vector<int> batch(state.range(0));
+  std::iota(batch.begin(), batch.end(), 0);
+  for (auto _ : state) {
+    stack.PushFront(batch.begin(), batch.end());
+    for (size_t i = 0; i < batch.size(); ++i) {
+      benchmark::DoNotOptimize(stack.PopFront());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0) * 2);
+}
+
 
 BENCHMARK(BM_CustomListPushFront)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
 BENCHMARK(BM_StdListPushFront)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
@@ -153,6 +449,22 @@ BENCHMARK(BM_CustomListClear)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark
 BENCHMARK(BM_StdListClear)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
 BENCHMARK(BM_CustomListFind)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
 BENCHMARK(BM_StdListFind)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CustomListSort)->Range(1<<10, 1<<20)->Complexity(benchmark::oNLogN)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CustomListSortViaVector)->Range(1<<10, 1<<20)->Complexity(benchmark::oNLogN)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_StdListSort)->Range(1<<10, 1<<20)->Complexity(benchmark::oNLogN)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_LockFreeStackPushPop)->ThreadRange(1, 32)->UseRealTime();
+BENCHMARK(BM_LockFreeStackEbrPushPop)->ThreadRange(1, 32)->UseRealTime();
+BENCHMARK(BM_MutexForwardListPushPop)->ThreadRange(1, 32)->UseRealTime();
+BENCHMARK(BM_LockFreeStackBatchPush)->Range(1<<4, 1<<10)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(BM_CustomListTraverse)->Range(1<<10, 1<<22)->Complexity()->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_StdListTraverse)->Range(1<<10, 1<<22)->Complexity()->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_CustomListTraverseChurned)->Range(1<<10, 1<<22)->Complexity()->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_StdListTraverseChurned)->Range(1<<10, 1<<22)->Complexity()->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_CustomListRangeConstruct)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CustomListPushFrontConstruct)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_StdListRangeConstruct)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CustomListTraverseBulk)->Range(1<<10, 1<<22)->Complexity()->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_StdListTraverseBulk)->Range(1<<10, 1<<22)->Complexity()->Unit(benchmark::kMicrosecond);
 
 
 BENCHMARK_MAIN();
\ No newline at end of file
@@ -1,10 +1,20 @@
+#include <algorithm>
+#include <atomic>
 #include <forward_list>
+#include <memory>
 #include <thread>
 #include <future>
+#include <iterator>
+#include <sstream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
 #include <fmt/core.h>
 #include <gtest/gtest.h>
 
 #include "../forward_list.hpp"
+#include "../lock_free_stack.hpp"
 
 class ListTest: public testing::Test {
   protected:
@@ -206,6 +216,278 @@ TEST_F(ListTest, Clear) {
 }
 
 
+template <typename T>
+std::vector<T> ToVector(const ForwardList<T>& list) {
+  std::vector<T> out;
+  for (auto it = list.Begin(); it != list.End(); ++it) {
+    out.push_back(*it);
+  }
+  return out;
+}
+
+TEST_F(ListTest, Reverse) {
+  list.Reverse();
+  ASSERT_EQ(ToVector(list), (std::vector<int>{1, 2, 3, 4, 5, 6, 7}));
+  ASSERT_EQ(list.Size(), sz);
+}
+
+TEST(AlgorithmsListTest, SortIsStable) {
+  ForwardList<std::pair<int, int>> list{{3, 0}, {1, 1}, {3, 2}, {2, 3}, {1, 4}, {0, 5}};
+  list.Sort([](const auto& a, const auto& b) { return a.first < b.first; });
+  std::vector<std::pair<int, int>> expected{{0, 5}, {1, 1}, {1, 4}, {2, 3}, {3, 0}, {3, 2}};
+  ASSERT_EQ(ToVector(list), expected);
+}
+
+TEST(AlgorithmsListTest, SortMatchesStd) {
+  std::mt19937 mt(17);
+  for (int sz : {0, 1, 2, 3, 7, 64, 1000, 4097}) {
+    std::vector<int> values(sz);
+    for (auto& v : values) {
+      v = mt() % 100;
+    }
+    ForwardList<int> list;
+    for (auto it = values.rbegin(); it != values.rend(); ++it) {
+      list.PushFront(*it);
+    }
+    list.Sort();
+    std::stable_sort(values.begin(), values.end());
+    ASSERT_EQ(ToVector(list), values);
+    ASSERT_EQ(list.Size(), values.size());
+  }
+}
+
+TEST(AlgorithmsListTest, Merge) {
+  ForwardList<int> a{1, 4, 6};
+  ForwardList<int> b{2, 4, 5, 9};
+  a.Merge(b);
+  ASSERT_EQ(ToVector(a), (std::vector<int>{1, 2, 4, 4, 5, 6, 9}));
+  ASSERT_EQ(a.Size(), 7);
+  ASSERT_TRUE(b.IsEmpty());
+}
+
+TEST(AlgorithmsListTest, SpliceAfter) {
+  ForwardList<int> a{1, 5};
+  ForwardList<int> b{2, 3, 4};
+  a.SpliceAfter(a.Begin(), b);
+  ASSERT_EQ(ToVector(a), (std::vector<int>{1, 2, 3, 4, 5}));
+  ASSERT_EQ(a.Size(), 5);
+  ASSERT_TRUE(b.IsEmpty());
+
+  ForwardList<int> c{0};
+  a.SpliceAfter(a.End(), c);
+  ASSERT_EQ(a.Front(), 0);
+}
+
+TEST(AlgorithmsListTest, SpliceAfterSingleNode) {
+  ForwardList<int> a{1, 3};
+  ForwardList<int> b{10, 2, 20};
+  a.SpliceAfter(a.Begin(), b, b.Begin());
+  ASSERT_EQ(ToVector(a), (std::vector<int>{1, 2, 3}));
+  ASSERT_EQ(ToVector(b), (std::vector<int>{10, 20}));
+  ASSERT_EQ(b.Size(), 2);
+}
+
+TEST(AlgorithmsListTest, RemoveIfAndUnique) {
+  ForwardList<int> list{1, 1, 2, 3, 3, 3, 4, 5, 5};
+  ASSERT_EQ(list.Unique(), 4);
+  ASSERT_EQ(ToVector(list), (std::vector<int>{1, 2, 3, 4, 5}));
+  ASSERT_EQ(list.RemoveIf([](int v) { return v % 2 == 1; }), 3);
+  ASSERT_EQ(ToVector(list), (std::vector<int>{2, 4}));
+  ASSERT_EQ(list.Size(), 2);
+}
+
+TEST(BulkListTest, RangeConstructor) {
+  std::vector<int> values(1000);
+  std::iota(values.begin(), values.end(), 0);
+  ForwardList<int> list(values.begin(), values.end());
+  ASSERT_EQ(list.Size(), values.size());
+  ASSERT_EQ(ToVector(list), values);
+}
+
+TEST(BulkListTest, NodesAreContiguous) {
+  std::vector<int> values(100);
+  std::iota(values.begin(), values.end(), 0);
+  ForwardList<int> list(values.begin(), values.end());
+  const int* prev = nullptr;
+  ptrdiff_t stride = 0;
+  for (auto it = list.Begin(); it != list.End(); ++it) {
+    const int* cur = &*it;
+    if (prev != nullptr) {
+      ptrdiff_t diff = reinterpret_cast<const char*>(cur) - reinterpret_cast<const char*>(prev);
+      if (stride == 0) {
+        stride = diff;
+      }
+      ASSERT_GT(diff, 0);
+      ASSERT_EQ(diff, stride) << "Bulk-built nodes aren't laid out in list order";
+    }
+    prev = cur;
+  }
+}
+
+TEST(BulkListTest, AssignFromInputIterator) {
+  std::istringstream in("5 4 3 2 1");
+  ForwardList<int> list{7, 8};
+  list.Assign(std::istream_iterator<int>(in), std::istream_iterator<int>());
+  ASSERT_EQ(ToVector(list), (std::vector<int>{5, 4, 3, 2, 1}));
+  ASSERT_EQ(list.Size(), 5);
+
+  list.Assign({1, 2});
+  ASSERT_EQ(ToVector(list), (std::vector<int>{1, 2}));
+}
+
+TEST(BulkListTest, ModifyAfterBulkBuild) {
+  std::vector<std::string> values{"a", "b", "c", "d"};
+  ForwardList<std::string> list(values.begin(), values.end());
+  list.EraseAfter(list.Begin());
+  list.PopFront();
+  list.PushFront("x");
+  list.InsertAfter(list.Begin(), "y");
+  ASSERT_EQ(ToVector(list), (std::vector<std::string>{"x", "y", "c", "d"}));
+
+  ForwardList<std::string> other(values.begin(), values.end());
+  list.SpliceAfter(list.Begin(), other, other.Begin());
+  ASSERT_EQ(ToVector(list), (std::vector<std::string>{"x", "b", "y", "c", "d"}));
+  ASSERT_EQ(ToVector(other), (std::vector<std::string>{"a", "c", "d"}));
+  other.Clear();
+  list.Merge(other);
+  ASSERT_EQ(list.Size(), 5);
+}
+
+TEST(BulkListTest, SplicedNodeOutlivesItsSource) {
+  ForwardList<std::string> target{"x"};
+  {
+    std::vector<std::string> values{"a", "b", "c"};
+    ForwardList<std::string> source(values.begin(), values.end());
+    const std::string* moved = &*++source.Begin();
+    target.SpliceAfter(target.Begin(), source, source.Begin());
+    ASSERT_EQ(&*++target.Begin(), moved) << "Splice copied the node instead of relinking it";
+    source.PopFront();
+  }
+  ASSERT_EQ(ToVector(target), (std::vector<std::string>{"x", "b"}));
+  target.PopFront();
+  ASSERT_EQ(target.Front(), "b");
+}
+
+TEST(BulkListTest, ThrowingCopyLeavesListEmpty) {
+  struct Flaky {
+    Flaky() = default;
+    Flaky(const Flaky& other) : id(other.id) {
+      if (id == 3) {
+        throw std::runtime_error("copy failed");
+      }
+    }
+    int id{0};
+  };
+  std::vector<Flaky> values(5);
+  for (int i = 0; i < 5; ++i) {
+    values[i].id = i;
+  }
+  ForwardList<Flaky> list;
+  ASSERT_THROW(list.Assign(values.begin(), values.end()), std::runtime_error);
+  ASSERT_TRUE(list.IsEmpty());
+}
+
+TEST(LockFreeStackTest, PushPopOrder) {
+  LockFreeStack<int> stack;
+  ASSERT_TRUE(stack.IsEmpty());
+  stack.PushFront(1);
+  stack.PushFront(2);
+  ASSERT_EQ(stack.Size(), 2);
+  ASSERT_EQ(stack.PopFront(), 2);
+  ASSERT_EQ(stack.PopFront(), 1);
+  ASSERT_EQ(stack.PopFront(), std::nullopt);
+  ASSERT_TRUE(stack.IsEmpty());
+}
+
+TEST(LockFreeStackTest, BatchPushFront) {
+  LockFreeStack<std::string> stack;
+  stack.PushFront("bottom");
+  std::vector<std::string> batch{"a", "b", "c"};
+  stack.PushFront(batch.begin(), batch.end());
+  ASSERT_EQ(stack.Size(), 4);
+  ASSERT_EQ(stack.PopFront(), "c");
+  ASSERT_EQ(stack.PopFront(), "b");
+  ASSERT_EQ(stack.PopFront(), "a");
+  ASSERT_EQ(stack.PopFront(), "bottom");
+}
+
+TEST(LockFreeStackTest, DestroysRemainingValues) {
+  auto shared = std::make_shared<int>(0);
+  {
+    LockFreeStack<std::shared_ptr<int>> stack;
+    stack.PushFront(shared);
+    stack.PushFront(shared);
+    stack.PopFront();
+    ASSERT_EQ(shared.use_count(), 2);
+  }
+  ASSERT_EQ(shared.use_count(), 1);
+}
+
+template <typename Stack>
+void RunProducersAndConsumers() {
+  constexpr int kThreads = 4;
+  constexpr int kPerThread = 20000;
+  Stack stack;
+  std::atomic<int64_t> popped_sum{0};
+  std::atomic<int> popped_count{0};
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&, t] {
+      for (int i = 0; i < kPerThread; ++i) {
+        int value = t * kPerThread + i;
+        if (i % 8 == 0) {
+          int batch[2] = {value, -1};
+          stack.PushFront(batch, batch + 1);
+        } else {
+          stack.PushFront(value);
+        }
+        if (auto top = stack.PopFront()) {
+          popped_sum += *top;
+          ++popped_count;
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  while (auto top = stack.PopFront()) {
+    popped_sum += *top;
+    ++popped_count;
+  }
+
+  int64_t total = kThreads * kPerThread;
+  ASSERT_EQ(popped_count.load(), total);
+  ASSERT_EQ(popped_sum.load(), total * (total - 1) / 2);
+  ASSERT_EQ(stack.Size(), 0);
+}
+
+TEST(LockFreeStackTest, ConcurrentProducersAndConsumers) {
+  RunProducersAndConsumers<LockFreeStack<int>>();
+}
+
+TEST(LockFreeStackTest, ConcurrentWithEpochReclamation) {
+  RunProducersAndConsumers<LockFreeStack<int, EpochReclamation>>();
+}
+
+TEST(LockFreeStackTest, EpochReclamationRetiresPoppedNodes) {
+  LockFreeStack<std::string, EpochReclamation> stack;
+  std::vector<std::string> values(1000, "payload that lives on the heap");
+  stack.PushFront(values.begin(), values.end());
+  size_t popped = 0;
+  while (auto top = stack.PopFront()) {
+    ASSERT_EQ(*top, values.front());
+    ++popped;
+  }
+  ASSERT_EQ(popped, values.size());
+  for (int i = 0; i < 3; ++i) {
+    ebr::Domain::Global().Collect();
+  }
+  ASSERT_EQ(ebr::Domain::Global().PendingCount(), 0) << "Popped nodes are never freed";
+}
+
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
 
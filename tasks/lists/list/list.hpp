@@ -189,21 +189,8 @@ public:
         if (!n) {
             return;
         }
-
-        if (n->prev_) {
-            n->prev_->next_ = n->next_;
-        } else {
-            head_ = n->next_;
-        }
-
-        if (n->next_) {
-            n->next_->prev_ = n->prev_;
-        } else {
-            tail_ = n->prev_;
-        }
-
+        Unlink(n);
         delete n;
-        --size_;
     }
 
     void Insert(ListIterator pos, const T& value) {
@@ -236,24 +223,45 @@ public:
     }
 
     void PushBack(const T& value) {
-        Node* nn = new Node(value, tail_, nullptr);
-        if (tail_) {
-            tail_->next_ = nn;
-        } else {
-            head_ = nn;
-        }
-        tail_ = nn;
-        ++size_;
+        LinkBack(new Node(value, tail_, nullptr));
+    }
+
+    void PushBack(T&& value) {
+        LinkBack(new Node(std::move(value), tail_, nullptr));
     }
 
     void PushFront(const T& value) {
-        Node* nn = new Node(value, nullptr, head_);
-        if (head_) {
-            head_->prev_ = nn;
+        LinkFront(new Node(value, nullptr, head_));
+    }
+
+    void PushFront(T&& value) {
+        LinkFront(new Node(std::move(value), nullptr, head_));
+    }
+
+    // Moves the node at `it` out of `other` and links it before `pos`.
+    // No allocation happens, so iterators to the moved element stay valid.
+    void Splice(ListIterator pos, List& other, ListIterator it) {
+        Node* n = it.current_;
+        if (n == nullptr || n == pos.current_) {
+            return;
+        }
+        other.Unlink(n);
+
+        Node* at = pos.current_;
+        if (at == nullptr) {
+            n->prev_ = tail_;
+            n->next_ = nullptr;
+            LinkBack(n);
+            return;
+        }
+        n->prev_ = at->prev_;
+        n->next_ = at;
+        if (at->prev_) {
+            at->prev_->next_ = n;
         } else {
-            tail_ = nn;
+            head_ = n;
         }
-        head_ = nn;
+        at->prev_ = n;
         ++size_;
     }
 
@@ -291,6 +299,42 @@ public:
         Clear();
     }
 
+private:
+    void LinkBack(Node* nn) {
+        if (tail_) {
+            tail_->next_ = nn;
+        } else {
+            head_ = nn;
+        }
+        tail_ = nn;
+        ++size_;
+    }
+
+    void LinkFront(Node* nn) {
+        if (head_) {
+            head_->prev_ = nn;
+        } else {
+            tail_ = nn;
+        }
+        head_ = nn;
+        ++size_;
+    }
+
+    void Unlink(Node* n) {
+        if (n->prev_) {
+            n->prev_->next_ = n->next_;
+        } else {
+            head_ = n->next_;
+        }
+        if (n->next_) {
+            n->next_->prev_ = n->prev_;
+        } else {
+            tail_ = n->prev_;
+        }
+        n->prev_ = n->next_ = nullptr;
+        --size_;
+    }
+
 private:
     Node* head_{nullptr};
     Node* tail_{nullptr};
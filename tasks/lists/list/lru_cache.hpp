@@ -0,0 +1,187 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+
+#include "list.hpp"
+
+// Default cost of an entry for the byte limit: the inline size of key and value.
+// Pass a custom weigher to account for heap-owned payloads (strings, buffers, ...).
+template <typename Key, typename Value>
+struct LruDefaultWeigher {
+    size_t operator()(const Key& /*key*/, const Value& /*value*/) const noexcept {
+        return sizeof(Key) + sizeof(Value);
+    }
+};
+
+// Least-recently-used cache: List keeps the recency order (front is the hottest entry),
+// the hash index maps a key straight to its list node, so Get/Put/Erase are O(1).
+template <typename Key, typename Value, typename Hash = std::hash<Key>,
+          typename Weigher = LruDefaultWeigher<Key, Value>>
+class LruCache {
+private:
+    using Entry = std::pair<const Key, Value>;
+    using EntryIterator = typename List<Entry>::ListIterator;
+
+public:
+    using EvictionCallback = std::function<void(const Key&, Value&)>;
+
+    // A zero limit disables that dimension. At least one limit should be set,
+    // otherwise the cache never evicts.
+    explicit LruCache(size_t max_entries, size_t max_bytes = 0, Weigher weigher = Weigher())
+        : max_entries_(max_entries), max_bytes_(max_bytes), weigher_(std::move(weigher)) {
+        if (max_entries_ != 0) {
+            index_.reserve(max_entries_);
+        }
+    }
+
+    LruCache(const LruCache&) = delete;
+    LruCache& operator=(const LruCache&) = delete;
+
+    // Returns nullptr on miss. A hit moves the entry to the front.
+    Value* Get(const Key& key) {
+        auto found = index_.find(key);
+        if (found == index_.end()) {
+            ++misses_;
+            return nullptr;
+        }
+        ++hits_;
+        Touch(found->second);
+        return &found->second->second;
+    }
+
+    // Lookup that neither promotes the entry nor touches the counters.
+    bool Contains(const Key& key) const {
+        return index_.find(key) != index_.end();
+    }
+
+    void Put(const Key& key, const Value& value) {
+        Emplace(key, value);
+    }
+
+    void Put(const Key& key, Value&& value) {
+        Emplace(key, std::move(value));
+    }
+
+    bool Erase(const Key& key) {
+        auto found = index_.find(key);
+        if (found == index_.end()) {
+            return false;
+        }
+        EntryIterator it = found->second;
+        bytes_ -= weigher_(it->first, it->second);
+        index_.erase(found);
+        entries_.Erase(it);
+        return true;
+    }
+
+    void Clear() noexcept {
+        index_.clear();
+        entries_.Clear();
+        bytes_ = 0;
+    }
+
+    void SetEvictionCallback(EvictionCallback callback) {
+        on_evict_ = std::move(callback);
+    }
+
+    inline size_t Size() const noexcept {
+        return entries_.Size();
+    }
+
+    inline bool IsEmpty() const noexcept {
+        return entries_.IsEmpty();
+    }
+
+    inline size_t Bytes() const noexcept {
+        return bytes_;
+    }
+
+    inline size_t Hits() const noexcept {
+        return hits_;
+    }
+
+    inline size_t Misses() const noexcept {
+        return misses_;
+    }
+
+    inline size_t Evictions() const noexcept {
+        return evictions_;
+    }
+
+    void ResetStats() noexcept {
+        hits_ = misses_ = evictions_ = 0;
+    }
+
+private:
+    template <typename V>
+    void Emplace(const Key& key, V&& value) {
+        EntryIterator it;
+        size_t weight = 0;
+        auto found = index_.find(key);
+        if (found != index_.end()) {
+            it = found->second;
+            size_t old_weight = weigher_(it->first, it->second);
+            // Assign first: if it throws, the old value stays and so does its weight
+            it->second = std::forward<V>(value);
+            weight = weigher_(it->first, it->second);
+            bytes_ -= old_weight;
+            Touch(it);
+        } else {
+            entries_.PushFront(Entry(key, std::forward<V>(value)));
+            it = entries_.Begin();
+            try {
+                index_.emplace(key, it);
+            } catch (...) {
+                // An entry the index can not reach could never be found or evicted
+                entries_.Erase(it);
+                throw;
+            }
+            weight = weigher_(it->first, it->second);
+        }
+
+        bytes_ += weight;
+        // An entry heavier than the whole byte budget is not admitted,
+        // instead of flushing every other entry to make room for it.
+        if (max_bytes_ != 0 && weight > max_bytes_) {
+            Evict(it);
+        }
+        while (!entries_.IsEmpty() && IsOverflowed()) {
+            Evict(--entries_.End());
+        }
+    }
+
+    void Touch(EntryIterator it) {
+        entries_.Splice(entries_.Begin(), entries_, it);
+    }
+
+    bool IsOverflowed() const noexcept {
+        return (max_entries_ != 0 && entries_.Size() > max_entries_) || (max_bytes_ != 0 && bytes_ > max_bytes_);
+    }
+
+    void Evict(EntryIterator it) {
+        if (on_evict_) {
+            on_evict_(it->first, it->second);
+        }
+        bytes_ -= weigher_(it->first, it->second);
+        index_.erase(it->first);
+        entries_.Erase(it);
+        ++evictions_;
+    }
+
+private:
+    List<Entry> entries_;
+    std::unordered_map<Key, EntryIterator, Hash> index_;
+
+    size_t max_entries_{0};
+    size_t max_bytes_{0};
+    size_t bytes_{0};
+    Weigher weigher_;
+    EvictionCallback on_evict_;
+
+    size_t hits_{0};
+    size_t misses_{0};
+    size_t evictions_{0};
+};
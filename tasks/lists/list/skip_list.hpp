@@ -0,0 +1,450 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <random>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "exceptions.hpp"
+
+// Ordered set on top of a skip list: Insert, Erase, Find and LowerBound run in expected O(log n).
+// Level 0 is a doubly linked list, so iteration works exactly like List::ListIterator.
+template <typename T, typename Compare = std::less<T>>
+class SkipList {
+private:
+    static constexpr size_t kMaxHeight = 16;
+
+    // Node tower (`height_` forward links) is stored right after the node in the same pool slot
+    class Node {
+        friend class SkipList;
+        friend class SkipListIterator;
+
+        T value_;
+        Node* prev_{nullptr};
+        size_t height_{0};
+
+        Node(const T& val, size_t height) : value_(val), height_(height) {
+        }
+        Node(T&& val, size_t height) : value_(std::move(val)), height_(height) {
+        }
+
+        Node** Next() noexcept {
+            return reinterpret_cast<Node**>(this + 1);
+        }
+    };
+
+    // Bump allocator over large chunks with a free list per tower height.
+    // Nodes of a list end up packed together, and Clear() releases whole chunks.
+    class NodePool {
+    public:
+        NodePool() = default;
+        NodePool(const NodePool&) = delete;
+        NodePool& operator=(const NodePool&) = delete;
+
+        ~NodePool() {
+            Release();
+        }
+
+        void* Allocate(size_t height) {
+            if (free_[height - 1] != nullptr) {
+                FreeSlot* slot = free_[height - 1];
+                free_[height - 1] = slot->next;
+                return slot;
+            }
+            size_t bytes = SlotSize(height);
+            if (chunk_ == nullptr || offset_ + bytes > kChunkBytes) {
+                auto* chunk = static_cast<Chunk*>(::operator new(kChunkBytes, std::align_val_t{alignof(Node)}));
+                chunk->next = chunk_;
+                chunk_ = chunk;
+                offset_ = HeaderSize();
+            }
+            void* slot = reinterpret_cast<std::byte*>(chunk_) + offset_;
+            offset_ += bytes;
+            return slot;
+        }
+
+        void Deallocate(void* ptr, size_t height) noexcept {
+            auto* slot = static_cast<FreeSlot*>(ptr);
+            slot->next = free_[height - 1];
+            free_[height - 1] = slot;
+        }
+
+        void Release() noexcept {
+            while (chunk_ != nullptr) {
+                Chunk* next = chunk_->next;
+                ::operator delete(chunk_, std::align_val_t{alignof(Node)});
+                chunk_ = next;
+            }
+            offset_ = 0;
+            for (auto& head : free_) {
+                head = nullptr;
+            }
+        }
+
+        void Swap(NodePool& other) noexcept {
+            std::swap(chunk_, other.chunk_);
+            std::swap(offset_, other.offset_);
+            std::swap(free_, other.free_);
+        }
+
+    private:
+        struct Chunk {
+            Chunk* next;
+        };
+
+        struct FreeSlot {
+            FreeSlot* next;
+        };
+
+        static constexpr size_t kChunkBytes = 64 * 1024;
+
+        static constexpr size_t RoundUp(size_t bytes) noexcept {
+            return (bytes + alignof(Node) - 1) / alignof(Node) * alignof(Node);
+        }
+
+        static constexpr size_t HeaderSize() noexcept {
+            return RoundUp(sizeof(Chunk));
+        }
+
+        static constexpr size_t SlotSize(size_t height) noexcept {
+            return RoundUp(sizeof(Node) + height * sizeof(Node*));
+        }
+
+        static_assert(HeaderSize() + SlotSize(kMaxHeight) <= kChunkBytes, "Node doesn't fit into a pool chunk");
+
+        Chunk* chunk_{nullptr};
+        size_t offset_{0};
+        FreeSlot* free_[kMaxHeight]{};
+    };
+
+public:
+    class SkipListIterator {
+    public:
+        // NOLINTNEXTLINE
+        using value_type = T;
+        // NOLINTNEXTLINE
+        using reference = const value_type&;
+        // NOLINTNEXTLINE
+        using pointer = const value_type*;
+        // NOLINTNEXTLINE
+        using difference_type = std::ptrdiff_t;
+        // NOLINTNEXTLINE
+        using iterator_category = std::bidirectional_iterator_tag;
+
+        SkipListIterator() : current_(nullptr), tail_hint_(nullptr) {
+        }
+
+        bool operator==(const SkipListIterator& other) const {
+            return current_ == other.current_;
+        }
+
+        bool operator!=(const SkipListIterator& other) const {
+            return current_ != other.current_;
+        }
+
+        reference operator*() const {
+            if (current_ == nullptr) {
+                throw std::runtime_error("Dereferencing end iterator");
+            }
+            return current_->value_;
+        }
+
+        pointer operator->() const {
+            if (current_ == nullptr) {
+                throw std::runtime_error("Dereferencing end iterator");
+            }
+            return &current_->value_;
+        }
+
+        SkipListIterator& operator++() {
+            if (current_ != nullptr) {
+                current_ = current_->Next()[0];
+            }
+            return *this;
+        }
+
+        SkipListIterator operator++(int) {
+            SkipListIterator tmp = *this;
+            ++(*this);
+            return tmp;
+        }
+
+        SkipListIterator& operator--() {
+            if (current_ != nullptr) {
+                current_ = current_->prev_;
+            } else {
+                current_ = tail_hint_;
+            }
+            return *this;
+        }
+
+        SkipListIterator operator--(int) {
+            SkipListIterator tmp = *this;
+            --(*this);
+            return tmp;
+        }
+
+    private:
+        explicit SkipListIterator(Node* node, Node* tail_hint) : current_(node), tail_hint_(tail_hint) {
+        }
+
+        Node* current_{nullptr};
+        Node* tail_hint_{nullptr};
+
+        friend class SkipList;
+    };
+
+public:
+    SkipList() = default;
+
+    explicit SkipList(const Compare& comp) : comp_(comp) {
+    }
+
+    SkipList(const std::initializer_list<T>& values) {
+        for (const auto& v : values) {
+            Insert(v);
+        }
+    }
+
+    SkipList(const SkipList& other) : comp_(other.comp_) {
+        AppendSorted(other);
+    }
+
+    SkipList& operator=(const SkipList& other) {
+        if (this != &other) {
+            Clear();
+            comp_ = other.comp_;
+            AppendSorted(other);
+        }
+        return *this;
+    }
+
+    ~SkipList() {
+        Clear();
+    }
+
+    SkipListIterator Begin() const noexcept {
+        return SkipListIterator(head_[0], tail_);
+    }
+
+    SkipListIterator End() const noexcept {
+        return SkipListIterator(nullptr, tail_);
+    }
+
+    const T& Front() const {
+        if (IsEmpty()) {
+            throw ListIsEmptyException("List is empty");
+        }
+        return head_[0]->value_;
+    }
+
+    const T& Back() const {
+        if (IsEmpty()) {
+            throw ListIsEmptyException("List is empty");
+        }
+        return tail_->value_;
+    }
+
+    bool IsEmpty() const noexcept {
+        return size_ == 0;
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    void Swap(SkipList& other) noexcept {
+        std::swap(head_, other.head_);
+        std::swap(tail_, other.tail_);
+        std::swap(height_, other.height_);
+        std::swap(size_, other.size_);
+        std::swap(comp_, other.comp_);
+        std::swap(random_, other.random_);
+        pool_.Swap(other.pool_);
+    }
+
+    // First element that is not less than `value`
+    SkipListIterator LowerBound(const T& value) const {
+        Node* const* links = head_;
+        Node* candidate = nullptr;
+        for (size_t level = height_; level-- > 0;) {
+            while (links[level] != nullptr && comp_(links[level]->value_, value)) {
+                links = links[level]->Next();
+            }
+            candidate = links[level];
+        }
+        return SkipListIterator(candidate, tail_);
+    }
+
+    SkipListIterator Find(const T& value) const {
+        SkipListIterator it = LowerBound(value);
+        if (it.current_ != nullptr && !comp_(value, it.current_->value_)) {
+            return it;
+        }
+        return End();
+    }
+
+    bool Contains(const T& value) const {
+        return Find(value) != End();
+    }
+
+    // Keeps elements unique: inserting an equivalent value returns the existing one
+    std::pair<SkipListIterator, bool> Insert(const T& value) {
+        return Emplace(value);
+    }
+
+    std::pair<SkipListIterator, bool> Insert(T&& value) {
+        return Emplace(std::move(value));
+    }
+
+    bool Erase(const T& value) {
+        Node** update[kMaxHeight]{};
+        Node* prev = FindPredecessors(value, update);
+        Node* n = *update[0];
+        if (n == nullptr || comp_(value, n->value_)) {
+            return false;
+        }
+        Unlink(n, prev, update);
+        return true;
+    }
+
+    void Erase(SkipListIterator pos) {
+        if (pos.current_ != nullptr) {
+            Erase(pos.current_->value_);
+        }
+    }
+
+    void Clear() noexcept {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            for (Node* cur = head_[0]; cur != nullptr; cur = cur->Next()[0]) {
+                cur->value_.~T();
+            }
+        }
+        pool_.Release();
+        for (auto& link : head_) {
+            link = nullptr;
+        }
+        tail_ = nullptr;
+        height_ = 1;
+        size_ = 0;
+    }
+
+private:
+    template <typename V>
+    std::pair<SkipListIterator, bool> Emplace(V&& value) {
+        Node** update[kMaxHeight]{};
+        Node* prev = FindPredecessors(value, update);
+        Node* next = *update[0];
+        if (next != nullptr && !comp_(value, next->value_)) {
+            return {SkipListIterator(next, tail_), false};
+        }
+
+        size_t height = RandomHeight();
+        for (size_t level = height_; level < height; ++level) {
+            update[level] = &head_[level];
+        }
+        height_ = std::max(height_, height);
+
+        Node* n = new (pool_.Allocate(height)) Node(std::forward<V>(value), height);
+        Node** links = n->Next();
+        for (size_t level = 0; level < height; ++level) {
+            links[level] = *update[level];
+            *update[level] = n;
+        }
+        n->prev_ = prev;
+        if (next != nullptr) {
+            next->prev_ = n;
+        } else {
+            tail_ = n;
+        }
+        ++size_;
+        return {SkipListIterator(n, tail_), true};
+    }
+
+    // Fills update[level] with the link that points to the first node not less than `value`.
+    // Returns the level-0 predecessor (nullptr if it is the head).
+    Node* FindPredecessors(const T& value, Node** update[]) {
+        Node** links = head_;
+        Node* prev = nullptr;
+        for (size_t level = height_; level-- > 0;) {
+            while (links[level] != nullptr && comp_(links[level]->value_, value)) {
+                prev = links[level];
+                links = prev->Next();
+            }
+            update[level] = &links[level];
+        }
+        return prev;
+    }
+
+    void Unlink(Node* n, Node* prev, Node** update[]) {
+        Node** links = n->Next();
+        for (size_t level = 0; level < n->height_; ++level) {
+            *update[level] = links[level];
+        }
+        if (links[0] != nullptr) {
+            links[0]->prev_ = prev;
+        } else {
+            tail_ = prev;
+        }
+        while (height_ > 1 && head_[height_ - 1] == nullptr) {
+            --height_;
+        }
+
+        size_t height = n->height_;
+        n->~Node();
+        pool_.Deallocate(n, height);
+        --size_;
+    }
+
+    // Source is already sorted, so every node is linked at the tail without searching
+    void AppendSorted(const SkipList& other) {
+        Node** last[kMaxHeight];
+        for (size_t level = 0; level < kMaxHeight; ++level) {
+            last[level] = &head_[level];
+        }
+        for (Node* cur = other.head_[0]; cur != nullptr; cur = cur->Next()[0]) {
+            size_t height = RandomHeight();
+            height_ = std::max(height_, height);
+            Node* n = new (pool_.Allocate(height)) Node(cur->value_, height);
+            Node** links = n->Next();
+            for (size_t level = 0; level < height; ++level) {
+                links[level] = nullptr;
+                *last[level] = n;
+                last[level] = &links[level];
+            }
+            n->prev_ = tail_;
+            tail_ = n;
+            ++size_;
+        }
+    }
+
+    // Geometric distribution with p = 1/4: every pair of zero bits adds a level
+    size_t RandomHeight() {
+        uint64_t bits = random_() | (uint64_t{1} << (2 * (kMaxHeight - 1)));
+        return static_cast<size_t>(std::countr_zero(bits)) / 2 + 1;
+    }
+
+private:
+    Node* head_[kMaxHeight]{};
+    Node* tail_{nullptr};
+    size_t height_{1};
+    size_t size_{0};
+    Compare comp_;
+    std::mt19937_64 random_{0x5eed};
+    NodePool pool_;
+};
+
+namespace std {
+template <typename T, typename Compare>
+void swap(SkipList<T, Compare>& a, SkipList<T, Compare>& b) {  // NOLINT
+    a.Swap(b);
+}
+}  // namespace std
@@ -1,11 +1,19 @@
+#include <algorithm>
+#include <cmath>
 #include <random>
 #include <list>
 #include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #include <benchmark/benchmark.h>
 #include <fmt/core.h>
+#include <profiling/profiling.hpp>
 
 #include "../list.hpp"
+#include "../lru_cache.hpp"
+#include "../skip_list.hpp"
 
 void ConstructRandomList(List<int>& list, int sz) {
   std::random_device rd;
@@ -34,17 +42,31 @@ void ConstructRandomList(std::list<int>& list, int sz) {
 ////////////////////////////////////////////////////////////////////////////////
 void BM_CustomListPushBack(benchmark::State& state) {
   List<int> list;
+  profiling::AllocationScope allocs;
   for (auto _ : state) {
     ConstructRandomList(list, state.range(0));
   }
+  allocs.Report(state, state.iterations() * state.range(0));
+  state.counters["bytes_per_elem"] = profiling::BytesPerElement(state.range(0), [&] {
+    List<int> fresh;
+    ConstructRandomList(fresh, state.range(0));
+    benchmark::DoNotOptimize(fresh);
+  });
   state.SetComplexityN(state.range(0));
 }
 
 void BM_StdListPushBack(benchmark::State& state) {
   std::list<int> list;
+  profiling::AllocationScope allocs;
   for (auto _ : state) {
     ConstructRandomList(list, state.range(0));
   }
+  allocs.Report(state, state.iterations() * state.range(0));
+  state.counters["bytes_per_elem"] = profiling::BytesPerElement(state.range(0), [&] {
+    std::list<int> fresh;
+    ConstructRandomList(fresh, state.range(0));
+    benchmark::DoNotOptimize(fresh);
+  });
   state.SetComplexityN(state.range(0));
 }
 
@@ -53,11 +75,13 @@ void BM_CustomListMiddleInsert(benchmark::State& state) {
   ConstructRandomList(list, 100);
   auto it = list.Begin();
   std::advance(it, 50);
+  profiling::AllocationScope allocs;
   for (auto _ : state) {
     for (int i = 0; i < state.range(0); ++i){
       list.Insert(it, 50);
     }
   }
+  allocs.Report(state, state.iterations() * state.range(0));
   state.SetComplexityN(state.range(0));
 }
 
@@ -66,51 +90,61 @@ void BM_StdListMiddleInsert(benchmark::State& state) {
   ConstructRandomList(list, 100);
   auto it = list.begin();
   std::advance(it, 50);
+  profiling::AllocationScope allocs;
   for (auto _ : state) {
     for (int i = 0; i < state.range(0); ++i){
       list.insert(it, 50);
     }
   }
+  allocs.Report(state, state.iterations() * state.range(0));
   state.SetComplexityN(state.range(0));
 }
 
 void BM_CustomListErase(benchmark::State& state) {
   List<int> list;
+  profiling::AllocationScope allocs;
   for (auto _ : state) {
     ConstructRandomList(list, state.range(0));
     for (int64_t i = 0; i < state.range(0); ++i) {
       list.Erase(list.Begin());
     }
   }
+  allocs.Report(state, state.iterations() * state.range(0));
   state.SetComplexityN(state.range(0));
 }
 
 void BM_StdListErase(benchmark::State& state) {
   std::list<int> list;
+  profiling::AllocationScope allocs;
   for (auto _ : state) {
     ConstructRandomList(list, state.range(0));
     for (int64_t i = 0; i < state.range(0); ++i) {
       list.erase(list.begin());
     }
   }
+  allocs.Report(state, state.iterations() * state.range(0));
   state.SetComplexityN(state.range(0));
 }
 
 void BM_CustomListClear(benchmark::State& state) {
   List<int> list;
+  profiling::AllocationScope allocs;
   for (auto _ : state) {
     ConstructRandomList(list, state.range(0));
     list.Clear();
   }
+  allocs.Report(state, state.iterations() * state.range(0));
   state.SetComplexityN(state.range(0));
 }
 
 void BM_StdListClear(benchmark::State& state) {
   std::list<int> list;
+  profiling::AllocationScope allocs;
   for (auto _ : state) {
     ConstructRandomList(list, state.range(0));
     list.clear();
   }
+  allocs.Report(state, state.iterations() * state.range(0));
   state.SetComplexityN(state.range(0));
 }
 
@@ -142,6 +176,243 @@ void BM_StdListFind(benchmark::State& state) {
   state.SetComplexityN(state.range(0));
 }
 
+// Draws keys from [0, n) with P(k) ~ 1 / (k + 1)^s via inverse CDF lookup
+class ZipfianGenerator {
+public:
+  ZipfianGenerator(size_t n, double s, uint32_t seed) : cdf_(n), mt_(seed) {
+    double sum = 0;
+    for (size_t k = 0; k < n; ++k) {
+      sum += 1.0 / std::pow(static_cast<double>(k + 1), s);
+      cdf_[k] = sum;
+    }
+    for (auto& p : cdf_) {
+      p /= sum;
+    }
+  }
+
+  int operator()() {
+    double u = dist_(mt_);
+    auto it = std::lower_bound(cdf_.begin(), cdf_.end(), u);
+    return static_cast<int>(std::min<size_t>(it - cdf_.begin(), cdf_.size() - 1));
+  }
+
+private:
+  std::vector<double> cdf_;
+  std::mt19937 mt_;
+  std::uniform_real_distribution<double> dist_{0.0, 1.0};
+};
+
+std::vector<int> MakeZipfianTrace(size_t universe, size_t length) {
+  ZipfianGenerator gen(universe, 0.99, 42);
+  std::vector<int> trace(length);
+  for (auto& key : trace) {
+    key = gen();
+  }
+  return trace;
+}
+
+// The hand-rolled cache LruCache replaces: List::Find on every access
+class ListScanLru {
+public:
+  explicit ListScanLru(size_t capacity) : capacity_(capacity) {
+  }
+
+  bool Access(int key) {
+    auto it = entries_.Find({key, 0});
+    if (it != entries_.End()) {
+      auto entry = *it;
+      entries_.Erase(it);
+      entries_.PushFront(entry);
+      return true;
+    }
+    entries_.PushFront({key, key});
+    if (entries_.Size() > capacity_) {
+      entries_.PopBack();
+    }
+    return false;
+  }
+
+private:
+  struct Entry {
+    int key;
+    int value;
+    bool operator==(const Entry& other) const {
+      return key == other.key;
+    }
+  };
+
+  List<Entry> entries_;
+  size_t capacity_;
+};
+
+constexpr size_t kLruUniverse = 1 << 20;
+constexpr size_t kLruTraceLength = 1 << 16;
+
+void BM_LruCacheZipfian(benchmark::State& state) {
+  const size_t capacity = state.range(0);
+  auto trace = MakeZipfianTrace(kLruUniverse, kLruTraceLength);
+  LruCache<int, int> cache(capacity);
+  for (auto _ : state) {
+    for (int key : trace) {
+      if (cache.Get(key) == nullptr) {
+        cache.Put(key, key);
+      }
+    }
+  }
+  state.counters["hit_ratio"] =
+      static_cast<double>(cache.Hits()) / static_cast<double>(cache.Hits() + cache.Misses());
+  state.SetItemsProcessed(state.iterations() * trace.size());
+  state.SetComplexityN(state.range(0));
+}
+
+void BM_ListScanLruZipfian(benchmark::State& state) {
+  const size_t capacity = state.range(0);
+  auto trace = MakeZipfianTrace(kLruUniverse, kLruTraceLength);
+  ListScanLru cache(capacity);
+  size_t hits = 0;
+  size_t accesses = 0;
+  for (auto _ : state) {
+    for (int key : trace) {
+      hits += cache.Access(key);
+    }
+    accesses += trace.size();
+  }
+  state.counters["hit_ratio"] = static_cast<double>(hits) / static_cast<double>(accesses);
+  state.SetItemsProcessed(state.iterations() * trace.size());
+  state.SetComplexityN(state.range(0));
+}
+
+// Builds 0..sz-1 in allocation order, then erases and re-inserts `sz` random nodes at random
+// positions. Node addresses stop following list order, so traversal hits scattered heap lines.
+void ConstructChurnedList(List<int>& list, int sz) {
+  std::vector<List<int>::ListIterator> slots(sz);
+  for (int i = 0; i < sz; ++i) {
+    list.PushBack(i);
+    slots[i] = --list.End();
+  }
+  std::mt19937 mt(42);
+  std::uniform_int_distribution<int> dist(0, sz - 1);
+  for (int op = 0; op < sz; ++op) {
+    int victim = dist(mt);
+    int pos = dist(mt);
+    if (victim == pos) {
+      continue;
+    }
+    list.Erase(slots[victim]);
+    list.Insert(slots[pos], victim);
+    slots[victim] = std::prev(slots[pos]);
+  }
+}
+
+void ConstructChurnedList(std::list<int>& list, int sz) {
+  std::vector<std::list<int>::iterator> slots(sz);
+  for (int i = 0; i < sz; ++i) {
+    slots[i] = list.insert(list.end(), i);
+  }
+  std::mt19937 mt(42);
+  std::uniform_int_distribution<int> dist(0, sz - 1);
+  for (int op = 0; op < sz; ++op) {
+    int victim = dist(mt);
+    int pos = dist(mt);
+    if (victim == pos) {
+      continue;
+    }
+    list.erase(slots[victim]);
+    slots[victim] = list.insert(slots[pos], victim);
+  }
+}
+
+template <typename It>
+int64_t Traverse(It first, It last) {
+  int64_t sum = 0;
+  for (; first != last; ++first) {
+    sum += *first;
+  }
+  return sum;
+}
+
+template <typename ListType, typename Build>
+void RunTraversal(benchmark::State& state, Build build) {
+  ListType list;
+  build(list, state.range(0));
+  profiling::PerfCounters perf;
+  perf.Start();
+  for (auto _ : state) {
+    if constexpr (std::is_same_v<ListType, List<int>>) {
+      benchmark::DoNotOptimize(Traverse(list.Begin(), list.End()));
+    } else {
+      benchmark::DoNotOptimize(Traverse(list.begin(), list.end()));
+    }
+  }
+  perf.Stop();
+  perf.Report(state, static_cast<double>(state.iterations() * state.range(0)));
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetComplexityN(state.range(0));
+}
+
+void BM_CustomListTraverse(benchmark::State& state) {
+  RunTraversal<List<int>>(state, [](List<int>& list, int sz) { ConstructRandomList(list, sz); });
+}
+
+void BM_StdListTraverse(benchmark::State& state) {
+  RunTraversal<std::list<int>>(state, [](std::list<int>& list, int sz) { ConstructRandomList(list, sz); });
+}
+
+void BM_CustomListTraverseChurned(benchmark::State& state) {
+  RunTraversal<List<int>>(state, [](List<int>& list, int sz) { ConstructChurnedList(list, sz); });
+}
+
+void BM_StdListTraverseChurned(benchmark::State& state) {
+  RunTraversal<std::list<int>>(state, [](std::list<int>& list, int sz) { ConstructChurnedList(list, sz); });
+}
+
+std::vector<int> MakeSortedKeys(int sz) {
+  std::vector<int> keys(sz);
+  for (int i = 0; i < sz; ++i) {
+    keys[i] = 2 * i;
+  }
+  return keys;
+}
+
+void BM_SortedListFind(benchmark::State& state) {
+  List<int> list;
+  for (int key : MakeSortedKeys(state.range(0))) {
+    list.PushBack(key);
+  }
+  std::mt19937 mt(42);
+  std::uniform_int_distribution<int> dist(0, 2 * state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(list.Find(dist(mt)));
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+void BM_SkipListFind(benchmark::State& state) {
+  SkipList<int> list;
+  for (int key : MakeSortedKeys(state.range(0))) {
+    list.Insert(key);
+  }
+  std::mt19937 mt(42);
+  std::uniform_int_distribution<int> dist(0, 2 * state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(list.Find(dist(mt)));
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+void BM_SkipListRandomInsert(benchmark::State& state) {
+  std::random_device rd;
+  std::mt19937 mt(rd());
+  std::uniform_int_distribution<int> dist(INT_MIN, INT_MAX);
+  for (auto _ : state) {
+    SkipList<int> list;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+      list.Insert(dist(mt));
+    }
+  }
+  state.SetComplexityN(state.range(0));
+}
+
 
 BENCHMARK(BM_CustomListPushBack)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
 BENCHMARK(BM_StdListPushBack)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
@@ -153,6 +424,15 @@ BENCHMARK(BM_CustomListClear)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark
 BENCHMARK(BM_StdListClear)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
 BENCHMARK(BM_CustomListFind)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
 BENCHMARK(BM_StdListFind)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CustomListTraverse)->Range(1<<10, 1<<22)->Complexity()->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_StdListTraverse)->Range(1<<10, 1<<22)->Complexity()->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_CustomListTraverseChurned)->Range(1<<10, 1<<22)->Complexity()->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_StdListTraverseChurned)->Range(1<<10, 1<<22)->Complexity()->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_SortedListFind)->Range(1<<10, 1<<16)->Complexity(benchmark::oN);
+BENCHMARK(BM_SkipListFind)->Range(1<<10, 1<<20)->Complexity(benchmark::oLogN);
+BENCHMARK(BM_SkipListRandomInsert)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_LruCacheZipfian)->Range(1<<8, 1<<16)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ListScanLruZipfian)->Range(1<<8, 1<<12)->Complexity()->Unit(benchmark::kMillisecond);
 
 
 BENCHMARK_MAIN();
\ No newline at end of file
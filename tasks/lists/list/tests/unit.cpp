@@ -1,11 +1,17 @@
 #include <list>
+#include <random>
+#include <set>
 #include <thread>
 #include <future>
+#include <string>
+#include <vector>
 
 #include <fmt/core.h>
 #include <gtest/gtest.h>
 
 #include "../list.hpp"
+#include "../lru_cache.hpp"
+#include "../skip_list.hpp"
 
 class ListTest: public testing::Test {
   protected:
@@ -276,6 +282,229 @@ TEST_F(ListTest, Clear) {
 }
 
 
+TEST_F(ListTest, SpliceToFront) {
+  auto it = list.Find(5);
+  list.Splice(list.Begin(), list, it);
+  ASSERT_EQ(list.Size(), sz);
+  ASSERT_EQ(list.Front(), 5);
+  ASSERT_EQ(*it, 5);
+
+  std::vector<int> expected{5, 1, 2, 3, 4, 6, 7};
+  auto cur = list.Begin();
+  for (int value : expected) {
+    ASSERT_EQ(*cur++, value);
+  }
+}
+
+TEST_F(ListTest, SpliceBetweenLists) {
+  List<int> other{10, 20};
+  list.Splice(list.End(), other, other.Begin());
+  ASSERT_EQ(list.Size(), sz + 1);
+  ASSERT_EQ(other.Size(), 1);
+  ASSERT_EQ(list.Back(), 10);
+  ASSERT_EQ(other.Front(), 20);
+}
+
+TEST(LruCacheTest, GetPut) {
+  LruCache<int, std::string> cache(2);
+  cache.Put(1, "one");
+  cache.Put(2, "two");
+
+  ASSERT_NE(cache.Get(1), nullptr);
+  ASSERT_EQ(*cache.Get(1), "one");
+  ASSERT_EQ(cache.Get(3), nullptr);
+  ASSERT_EQ(cache.Hits(), 2);
+  ASSERT_EQ(cache.Misses(), 1);
+}
+
+TEST(LruCacheTest, EvictsLeastRecentlyUsed) {
+  LruCache<int, int> cache(2);
+  cache.Put(1, 10);
+  cache.Put(2, 20);
+  cache.Get(1);
+  cache.Put(3, 30);
+
+  ASSERT_EQ(cache.Size(), 2);
+  ASSERT_TRUE(cache.Contains(1));
+  ASSERT_FALSE(cache.Contains(2));
+  ASSERT_TRUE(cache.Contains(3));
+  ASSERT_EQ(cache.Evictions(), 1);
+}
+
+TEST(LruCacheTest, OverwriteKeepsSize) {
+  LruCache<int, int> cache(2);
+  cache.Put(1, 10);
+  cache.Put(1, 11);
+  ASSERT_EQ(cache.Size(), 1);
+  ASSERT_EQ(*cache.Get(1), 11);
+}
+
+TEST(LruCacheTest, Erase) {
+  LruCache<int, int> cache(4);
+  cache.Put(1, 10);
+  ASSERT_TRUE(cache.Erase(1));
+  ASSERT_FALSE(cache.Erase(1));
+  ASSERT_TRUE(cache.IsEmpty());
+  ASSERT_EQ(cache.Get(1), nullptr);
+}
+
+TEST(LruCacheTest, EvictionCallback) {
+  LruCache<int, int> cache(1);
+  std::vector<std::pair<int, int>> evicted;
+  cache.SetEvictionCallback([&](const int& key, int& value) {
+    evicted.emplace_back(key, value);
+  });
+  cache.Put(1, 10);
+  cache.Put(2, 20);
+  cache.Put(3, 30);
+
+  ASSERT_EQ(evicted.size(), 2);
+  ASSERT_EQ(evicted[0], std::make_pair(1, 10));
+  ASSERT_EQ(evicted[1], std::make_pair(2, 20));
+}
+
+TEST(LruCacheTest, ByteLimit) {
+  struct StringWeigher {
+    size_t operator()(const int&, const std::string& value) const {
+      return value.size();
+    }
+  };
+  LruCache<int, std::string, std::hash<int>, StringWeigher> cache(0, 10);
+  cache.Put(1, "aaaa");
+  cache.Put(2, "bbbb");
+  ASSERT_EQ(cache.Bytes(), 8);
+
+  cache.Put(3, "cccc");
+  ASSERT_EQ(cache.Size(), 2);
+  ASSERT_FALSE(cache.Contains(1));
+  ASSERT_EQ(cache.Bytes(), 8);
+
+  cache.Put(2, "b");
+  ASSERT_EQ(cache.Bytes(), 5);
+
+  cache.Put(4, "way too long value");
+  ASSERT_FALSE(cache.Contains(4));
+  ASSERT_EQ(cache.Bytes(), 5);
+}
+
+TEST(LruCacheTest, ThrowingOverwriteKeepsBytes) {
+  struct Payload {
+    size_t weight;
+
+    Payload(size_t weight) : weight(weight) {
+    }
+
+    Payload(const Payload&) = default;
+
+    Payload& operator=(const Payload& other) {
+      if (other.weight == 0) {
+        throw std::runtime_error("Rejected");
+      }
+      weight = other.weight;
+      return *this;
+    }
+  };
+  struct PayloadWeigher {
+    size_t operator()(const int&, const Payload& value) const {
+      return value.weight;
+    }
+  };
+  LruCache<int, Payload, std::hash<int>, PayloadWeigher> cache(0, 100);
+  cache.Put(1, Payload(7));
+  ASSERT_THROW(cache.Put(1, Payload(0)), std::runtime_error);
+  ASSERT_EQ(cache.Get(1)->weight, 7);
+  ASSERT_EQ(cache.Bytes(), 7);
+  cache.Put(1, Payload(3));
+  ASSERT_EQ(cache.Bytes(), 3);
+}
+
+
+TEST(SkipListTest, InsertKeepsOrder) {
+  SkipList<int> list{5, 1, 4, 2, 3};
+  ASSERT_EQ(list.Size(), 5);
+  ASSERT_EQ(list.Front(), 1);
+  ASSERT_EQ(list.Back(), 5);
+
+  int expected = 1;
+  for (auto it = list.Begin(); it != list.End(); ++it) {
+    ASSERT_EQ(*it, expected++);
+  }
+}
+
+TEST(SkipListTest, InsertDuplicate) {
+  SkipList<int> list;
+  ASSERT_TRUE(list.Insert(1).second);
+  auto [it, inserted] = list.Insert(1);
+  ASSERT_FALSE(inserted);
+  ASSERT_EQ(*it, 1);
+  ASSERT_EQ(list.Size(), 1);
+}
+
+TEST(SkipListTest, FindAndLowerBound) {
+  SkipList<int> list{10, 20, 30};
+  ASSERT_EQ(*list.Find(20), 20);
+  ASSERT_EQ(list.Find(25), list.End());
+  ASSERT_EQ(*list.LowerBound(25), 30);
+  ASSERT_EQ(*list.LowerBound(5), 10);
+  ASSERT_EQ(list.LowerBound(31), list.End());
+}
+
+TEST(SkipListTest, EraseAndReverseIteration) {
+  SkipList<int> list{1, 2, 3, 4, 5};
+  ASSERT_TRUE(list.Erase(3));
+  ASSERT_FALSE(list.Erase(3));
+  list.Erase(list.Find(5));
+  ASSERT_EQ(list.Size(), 3);
+  ASSERT_EQ(list.Back(), 4);
+
+  std::vector<int> expected{4, 2, 1};
+  auto it = list.End();
+  for (int value : expected) {
+    ASSERT_EQ(*--it, value);
+  }
+  ASSERT_EQ(it, list.Begin());
+}
+
+TEST(SkipListTest, EmptyThrows) {
+  SkipList<int> list;
+  EXPECT_THROW({
+    list.Front();
+  }, ListIsEmptyException);
+}
+
+TEST(SkipListTest, CopyAndClear) {
+  SkipList<std::string> list{"b", "a", "c"};
+  SkipList<std::string> copy = list;
+  list.Clear();
+  ASSERT_TRUE(list.IsEmpty());
+  ASSERT_EQ(copy.Size(), 3);
+  ASSERT_EQ(copy.Front(), "a");
+  ASSERT_TRUE(copy.Contains("c"));
+  list.Insert("z");
+  ASSERT_EQ(list.Front(), "z");
+}
+
+TEST(SkipListTest, MatchesStdSet) {
+  std::mt19937 mt(7);
+  std::uniform_int_distribution<int> dist(0, 2000);
+  SkipList<int, std::greater<int>> list;
+  std::set<int, std::greater<int>> reference;
+  for (int i = 0; i < 20000; ++i) {
+    int key = dist(mt);
+    if (mt() % 3 == 0) {
+      ASSERT_EQ(list.Erase(key), reference.erase(key) == 1);
+    } else {
+      ASSERT_EQ(list.Insert(key).second, reference.insert(key).second);
+    }
+  }
+  ASSERT_EQ(list.Size(), reference.size());
+  auto it = list.Begin();
+  for (int key : reference) {
+    ASSERT_EQ(*it++, key);
+  }
+}
+
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
 
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+
+// Augmentations for Map. A node keeps `Data` next to its entry, and Pull recomputes it from the
+// node's own entry and its children's data. The tree calls Pull bottom-up on every node whose
+// subtree changed: along the path of an insertion or removal, after rotations and on bulk builds.
+
+struct NoAugment {
+    static constexpr bool kEnabled = false;
+
+    struct Data {};
+
+    template <typename Node>
+    static void Pull(Node* /*node*/) noexcept {
+    }
+};
+
+// Number of nodes in the subtree: enables Select, Rank and CountLess in O(log n)
+struct SubtreeSize {
+    static constexpr bool kEnabled = true;
+
+    struct Data {
+        size_t size{1};
+    };
+
+    template <typename Node>
+    static size_t Size(const Node* node) noexcept {
+        return node != nullptr ? node->aug.size : 0;
+    }
+
+    template <typename Node>
+    static void Pull(Node* node) noexcept {
+        node->aug.size = 1 + Size(node->left) + Size(node->right);
+    }
+};
+
+// Largest right end in the subtree, for keys that are closed intervals with `low` and `high`
+// bounds, ordered by `low` first (see interval_map.hpp). A subtree whose largest end lies left of
+// a query cannot overlap it, so Overlaps skips it whole.
+template <typename Bound, typename Compare = std::less<Bound>>
+struct MaxEndpoint {
+    static constexpr bool kEnabled = true;
+
+    struct Data {
+        Bound max_high{};
+    };
+
+    template <typename Node>
+    static void Pull(Node* node) {
+        const Bound* max_high = &node->value.first.high;
+        for (const Node* child : {node->left, node->right}) {
+            if (child != nullptr && Compare{}(*max_high, child->aug.max_high)) {
+                max_high = &child->aug.max_high;
+            }
+        }
+        node->aug.max_high = *max_high;
+    }
+
+    // Calls `visit` on every entry of `tree` whose interval meets [low, high], in key order.
+    // O((k + 1) log n) for k reported entries on a balanced tree.
+    template <typename Tree, typename Visit>
+    static void Overlaps(const Tree& tree, const Bound& low, const Bound& high, Visit& visit) {
+        OverlapsIn(tree.root_, low, high, visit);
+    }
+
+private:
+    template <typename Node, typename Visit>
+    static void OverlapsIn(const Node* node, const Bound& low, const Bound& high, Visit& visit) {
+        Compare comp;
+        while (node != nullptr && !comp(node->aug.max_high, low)) {
+            OverlapsIn(node->left, low, high, visit);
+            // Every key from here on starts after the query ends
+            if (comp(high, node->value.first.low)) {
+                return;
+            }
+            if (!comp(node->value.first.high, low)) {
+                visit(node->value);
+            }
+            node = node->right;
+        }
+    }
+};
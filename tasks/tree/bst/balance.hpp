@@ -0,0 +1,392 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+// Balancing policies for Map. A policy keeps its per-node state in `Meta` and restores its
+// invariant after the tree has linked a new node or unlinked one. The tree grants the policy
+// access to RotateLeft/RotateRight and root_; nodes expose left, right, parent and meta.
+//
+// AfterErase receives the CLRS-style description of the removal: `z` is the erased node, `y`
+// the node that physically left its position (z itself, or z's successor moved into z's place),
+// `x` the child that took y's old position (may be nullptr) and `x_parent` its parent.
+//
+// AfterAccess is called with the node a point lookup found, or the last node it passed when
+// the key is absent. Only a policy with kSelfAdjusting restructures the tree there; the others
+// leave it empty, and Map skips the bookkeeping for them.
+//
+// AfterBuild sets up the metadata of a tree built in one go from sorted input. That tree is
+// perfectly balanced: levels above `full_levels` are complete, deeper nodes are leaves. It is
+// called for every node after both of its subtrees, with the node's depth (the root is at 0).
+//
+// Split, Join and the set operations of Map join trees of different sizes around a middle node.
+// A policy measures a tree by its rank (black height, height) and tells where the middle node
+// goes: Map walks down the spine of the higher tree until JoinsAt, hangs the middle node there
+// with the lower tree as its other child, and calls AfterJoin. ChildRank gives the rank of a
+// child from its parent's rank, MakeRoot makes a detached subtree a valid tree on its own.
+
+// Red-black tree: height <= 2 log(n + 1), at most three rotations per update
+struct RedBlackBalance {
+    static constexpr bool kSelfAdjusting = false;
+
+    struct Meta {
+        bool red{true};
+    };
+
+    template <typename Tree, typename Node>
+    static void AfterInsert(Tree& tree, Node* node) {
+        FixDoubleRed(tree, node);
+        tree.root_->meta.red = false;
+    }
+
+    template <typename Tree, typename Node>
+    static void AfterErase(Tree& tree, Node* z, Node* y, Node* x, Node* x_parent) {
+        bool removed_red = y->meta.red;
+        if (y != z) {
+            y->meta = z->meta;
+        }
+        if (removed_red) {
+            return;
+        }
+
+        while (x != tree.root_ && !IsRed(x)) {
+            bool x_is_left = x == x_parent->left;
+            Node* sibling = x_is_left ? x_parent->right : x_parent->left;
+
+            if (IsRed(sibling)) {
+                sibling->meta.red = false;
+                x_parent->meta.red = true;
+                Rotate(tree, x_parent, x_is_left);
+                sibling = x_is_left ? x_parent->right : x_parent->left;
+            }
+            Node* near = x_is_left ? sibling->left : sibling->right;
+            Node* far = x_is_left ? sibling->right : sibling->left;
+            if (!IsRed(near) && !IsRed(far)) {
+                sibling->meta.red = true;
+                x = x_parent;
+                x_parent = x->parent;
+                continue;
+            }
+            if (!IsRed(far)) {
+                near->meta.red = false;
+                sibling->meta.red = true;
+                Rotate(tree, sibling, !x_is_left);
+                sibling = x_is_left ? x_parent->right : x_parent->left;
+                far = x_is_left ? sibling->right : sibling->left;
+            }
+            sibling->meta.red = x_parent->meta.red;
+            x_parent->meta.red = false;
+            far->meta.red = false;
+            Rotate(tree, x_parent, x_is_left);
+            x = tree.root_;
+        }
+        if (x != nullptr) {
+            x->meta.red = false;
+        }
+    }
+
+    template <typename Tree, typename Node>
+    static void AfterAccess(Tree& /*tree*/, Node* /*node*/) noexcept {
+    }
+
+    // Every complete level is black; the leaves of an incomplete last level are red
+    template <typename Node>
+    static void AfterBuild(Node* node, int depth, int full_levels) noexcept {
+        node->meta.red = depth >= full_levels;
+    }
+
+    // Black nodes on a path from `root` down, counting the root itself. O(log n).
+    template <typename Node>
+    static int Rank(const Node* root) noexcept {
+        int rank = 0;
+        for (; root != nullptr; root = root->left) {
+            rank += root->meta.red ? 0 : 1;
+        }
+        return rank;
+    }
+
+    template <typename Node>
+    static int ChildRank(const Node* node, int rank, const Node* /*child*/) noexcept {
+        return node->meta.red ? rank : rank - 1;
+    }
+
+    // A red root turns black, which adds one to every path
+    template <typename Node>
+    static int MakeRoot(Node* root, int rank) noexcept {
+        if (IsRed(root)) {
+            root->meta.red = false;
+            return rank + 1;
+        }
+        return rank;
+    }
+
+    // The middle node replaces a black subtree as high as the lower tree, so it can be red
+    template <typename Node>
+    static bool JoinsAt(const Node* node, int rank, int other_rank) noexcept {
+        return rank == other_rank && !IsRed(node);
+    }
+
+    template <typename Tree, typename Node>
+    static int AfterJoin(Tree& tree, Node* mid, int rank) {
+        mid->meta.red = true;
+        FixDoubleRed(tree, mid);
+        return MakeRoot(tree.root_, rank);
+    }
+
+private:
+    template <typename Node>
+    static bool IsRed(const Node* node) noexcept {
+        return node != nullptr && node->meta.red;
+    }
+
+    // Pushes a red-red violation between red `node` and its parent up until it disappears,
+    // possibly leaving the root red
+    template <typename Tree, typename Node>
+    static void FixDoubleRed(Tree& tree, Node* node) {
+        while (IsRed(node->parent)) {
+            Node* parent = node->parent;
+            Node* grand = parent->parent;
+            bool parent_is_left = parent == grand->left;
+            Node* uncle = parent_is_left ? grand->right : grand->left;
+
+            if (IsRed(uncle)) {
+                parent->meta.red = false;
+                uncle->meta.red = false;
+                grand->meta.red = true;
+                node = grand;
+                continue;
+            }
+            if (node == (parent_is_left ? parent->right : parent->left)) {
+                node = parent;
+                Rotate(tree, node, parent_is_left);
+                parent = node->parent;
+            }
+            parent->meta.red = false;
+            grand->meta.red = true;
+            Rotate(tree, grand, !parent_is_left);
+        }
+    }
+
+    // Lifts the right child of `node` when `left` is set, the left child otherwise
+    template <typename Tree, typename Node>
+    static void Rotate(Tree& tree, Node* node, bool left) {
+        if (left) {
+            tree.RotateLeft(node);
+        } else {
+            tree.RotateRight(node);
+        }
+    }
+};
+
+// AVL tree: subtree heights differ by at most one, height <= 1.44 log n.
+// Lookups are a little faster than with red-black, updates rotate more.
+struct AvlBalance {
+    static constexpr bool kSelfAdjusting = false;
+
+    struct Meta {
+        int8_t height{1};
+    };
+
+    template <typename Tree, typename Node>
+    static void AfterInsert(Tree& tree, Node* node) {
+        Retrace(tree, node->parent);
+    }
+
+    template <typename Tree, typename Node>
+    static void AfterErase(Tree& tree, Node* z, Node* y, Node* /*x*/, Node* x_parent) {
+        if (y != z) {
+            y->meta = z->meta;
+        }
+        Retrace(tree, x_parent);
+    }
+
+    template <typename Tree, typename Node>
+    static void AfterAccess(Tree& /*tree*/, Node* /*node*/) noexcept {
+    }
+
+    template <typename Node>
+    static void AfterBuild(Node* node, int /*depth*/, int /*full_levels*/) noexcept {
+        Update(node);
+    }
+
+    template <typename Node>
+    static int Rank(const Node* root) noexcept {
+        return Height(root);
+    }
+
+    template <typename Node>
+    static int ChildRank(const Node* /*node*/, int /*rank*/, const Node* child) noexcept {
+        return Height(child);
+    }
+
+    template <typename Node>
+    static int MakeRoot(Node* /*root*/, int rank) noexcept {
+        return rank;
+    }
+
+    // Subtrees that differ in height by at most one make a balanced node
+    template <typename Node>
+    static bool JoinsAt(const Node* /*node*/, int rank, int other_rank) noexcept {
+        return rank <= other_rank + 1;
+    }
+
+    template <typename Tree, typename Node>
+    static int AfterJoin(Tree& tree, Node* mid, int /*rank*/) {
+        Update(mid);
+        Retrace(tree, mid->parent);
+        return Height(tree.root_);
+    }
+
+private:
+    template <typename Node>
+    static int Height(const Node* node) noexcept {
+        return node != nullptr ? node->meta.height : 0;
+    }
+
+    template <typename Node>
+    static void Update(Node* node) noexcept {
+        node->meta.height = static_cast<int8_t>(std::max(Height(node->left), Height(node->right)) + 1);
+    }
+
+    // Walks up, fixing heights and rotating any node that became unbalanced. Stops at the first
+    // subtree whose height has not changed: nothing above it is affected.
+    template <typename Tree, typename Node>
+    static void Retrace(Tree& tree, Node* node) {
+        while (node != nullptr) {
+            int before = node->meta.height;
+            Update(node);
+            int balance = Height(node->left) - Height(node->right);
+            if (balance > 1) {
+                if (Height(node->left->left) < Height(node->left->right)) {
+                    RotateLeft(tree, node->left);
+                }
+                node = RotateRight(tree, node);
+            } else if (balance < -1) {
+                if (Height(node->right->right) < Height(node->right->left)) {
+                    RotateRight(tree, node->right);
+                }
+                node = RotateLeft(tree, node);
+            }
+            if (node->meta.height == before) {
+                return;
+            }
+            node = node->parent;
+        }
+    }
+
+    template <typename Tree, typename Node>
+    static Node* RotateLeft(Tree& tree, Node* node) {
+        Node* top = node->right;
+        tree.RotateLeft(node);
+        Update(node);
+        Update(top);
+        return top;
+    }
+
+    template <typename Tree, typename Node>
+    static Node* RotateRight(Tree& tree, Node* node) {
+        Node* top = node->left;
+        tree.RotateRight(node);
+        Update(node);
+        Update(top);
+        return top;
+    }
+};
+
+// Splay tree: every inserted or looked-up node is rotated up to the root, so recently used
+// keys stay near the top. No balance is kept: a single operation may take O(n), but any sequence of m
+// operations takes O(m log n), and a skewed workload is served in far fewer steps than log n.
+//
+// Lookups restructure the tree, so const Find and Contains modify it: a SplayBalance map must not
+// be read from several threads at once. Split raises the split point to the root first, and the
+// set operations merge the trees in key order rather than recurse down paths of unbounded depth.
+struct SplayBalance {
+    static constexpr bool kSelfAdjusting = true;
+
+    struct Meta {};
+
+    template <typename Tree, typename Node>
+    static void AfterInsert(Tree& tree, Node* node) {
+        Splay(tree, node);
+    }
+
+    // The parent of the removed position goes up, as after a lookup that ended there
+    template <typename Tree, typename Node>
+    static void AfterErase(Tree& tree, Node* /*z*/, Node* /*y*/, Node* /*x*/, Node* x_parent) {
+        if (x_parent != nullptr) {
+            Splay(tree, x_parent);
+        }
+    }
+
+    template <typename Tree, typename Node>
+    static void AfterAccess(Tree& tree, Node* node) {
+        Splay(tree, node);
+    }
+
+    // Splays `node` to the root, as a lookup that found it would
+    template <typename Tree, typename Node>
+    static void Raise(Tree& tree, Node* node) {
+        Splay(tree, node);
+    }
+
+    template <typename Node>
+    static void AfterBuild(Node* /*node*/, int /*depth*/, int /*full_levels*/) noexcept {
+    }
+
+    // Without a balance invariant every tree has the same rank, and trees are joined at the top:
+    // the middle node becomes the root over both of them
+    template <typename Node>
+    static int Rank(const Node* /*root*/) noexcept {
+        return 0;
+    }
+
+    template <typename Node>
+    static int ChildRank(const Node* /*node*/, int /*rank*/, const Node* /*child*/) noexcept {
+        return 0;
+    }
+
+    template <typename Node>
+    static int MakeRoot(Node* /*root*/, int rank) noexcept {
+        return rank;
+    }
+
+    template <typename Node>
+    static bool JoinsAt(const Node* /*node*/, int /*rank*/, int /*other_rank*/) noexcept {
+        return true;
+    }
+
+    template <typename Tree, typename Node>
+    static int AfterJoin(Tree& /*tree*/, Node* /*mid*/, int /*rank*/) noexcept {
+        return 0;
+    }
+
+private:
+    // Rotates `node` up to the root two levels at a time. In the zig-zig case (node and parent
+    // lean the same way) the parent goes up first, which roughly halves the depth of the path and
+    // gives the amortized bound.
+    template <typename Tree, typename Node>
+    static void Splay(Tree& tree, Node* node) {
+        while (node->parent != nullptr) {
+            Node* parent = node->parent;
+            Node* grand = parent->parent;
+            if (grand == nullptr) {
+                RotateUp(tree, node);
+            } else if ((node == parent->left) == (parent == grand->left)) {
+                RotateUp(tree, parent);
+                RotateUp(tree, node);
+            } else {
+                RotateUp(tree, node);
+                RotateUp(tree, node);
+            }
+        }
+    }
+
+    template <typename Tree, typename Node>
+    static void RotateUp(Tree& tree, Node* node) {
+        if (node == node->parent->left) {
+            tree.RotateRight(node->parent);
+        } else {
+            tree.RotateLeft(node->parent);
+        }
+    }
+};
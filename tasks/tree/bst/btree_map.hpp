@@ -0,0 +1,712 @@
+#pragma once
+
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Ordered dictionary on a B+ tree with the Map interface.
+//
+// A node holds dozens of keys in a few cache lines, so a lookup touches O(log_B n) nodes
+// instead of O(log_2 n) scattered binary nodes. Keys and values live in separate arrays of the
+// leaves; inner nodes only route. Leaves are linked, which makes iteration a linear walk.
+// With std::less, 32- and 64-bit integer keys are compared a 16-byte block at a time (SSE2).
+// Key and Value must be default constructible and move assignable.
+template <typename Key, typename Value, typename Compare = std::less<Key>>
+class BTreeMap {
+private:
+    static constexpr size_t kNodeBytes = 256;
+    static constexpr size_t kLeafSlots = std::max<size_t>(4, kNodeBytes / (sizeof(Key) + sizeof(Value)));
+    static constexpr size_t kInnerSlots = std::max<size_t>(4, kNodeBytes / (sizeof(Key) + sizeof(void*)));
+    static constexpr size_t kMinLeaf = kLeafSlots / 2;
+    static constexpr size_t kMinInner = kInnerSlots / 2;
+    // Every inner node but the root has at least three children
+    static constexpr size_t kMaxDepth = 48;
+
+#if defined(__SSE2__)
+    // 32- and 64-bit integer keys with the default order
+    static constexpr bool kSimdSearch = std::is_same_v<Compare, std::less<Key>> && std::is_integral_v<Key> &&
+                                        (sizeof(Key) == 4 || sizeof(Key) == 8);
+#else
+    static constexpr bool kSimdSearch = false;
+#endif
+
+    struct Node {
+        uint16_t count{0};
+        bool is_leaf;
+
+        explicit Node(bool leaf) : is_leaf(leaf) {
+        }
+    };
+
+    struct alignas(64) Leaf : Node {
+        Leaf* prev{nullptr};
+        Leaf* next{nullptr};
+        Key keys[kLeafSlots];
+        Value values[kLeafSlots];
+
+        Leaf() : Node(true) {
+        }
+    };
+
+    // Child i holds the keys k with keys[i - 1] <= k < keys[i]
+    struct alignas(64) Inner : Node {
+        Key keys[kInnerSlots];
+        Node* children[kInnerSlots + 1];
+
+        Inner() : Node(false) {
+        }
+    };
+
+    struct PathEntry {
+        Inner* node;
+        size_t index;
+    };
+
+public:
+    class MapIterator {
+    public:
+        // NOLINTNEXTLINE
+        using value_type = std::pair<const Key, Value>;
+        // NOLINTNEXTLINE
+        using reference = std::pair<const Key&, Value&>;
+        // NOLINTNEXTLINE
+        using difference_type = std::ptrdiff_t;
+        // `reference` is a proxy, which a legacy bidirectional iterator may not have: only the
+        // C++20 concept admits it
+        // NOLINTNEXTLINE
+        using iterator_category = std::input_iterator_tag;
+        // NOLINTNEXTLINE
+        using iterator_concept = std::bidirectional_iterator_tag;
+
+        // Keys and values are stored apart, so `->` goes through a pair of references
+        class ArrowProxy {
+        public:
+            const reference* operator->() const noexcept {
+                return &ref_;
+            }
+
+        private:
+            explicit ArrowProxy(reference ref) : ref_(ref) {
+            }
+
+            reference ref_;
+
+            friend class MapIterator;
+        };
+
+        // NOLINTNEXTLINE
+        using pointer = ArrowProxy;
+
+        MapIterator() = default;
+
+        bool operator==(const MapIterator& other) const {
+            return leaf_ == other.leaf_ && index_ == other.index_;
+        }
+
+        bool operator!=(const MapIterator& other) const {
+            return !(*this == other);
+        }
+
+        reference operator*() const {
+            if (leaf_ == nullptr) {
+                throw std::runtime_error("Dereferencing end iterator");
+            }
+            return reference(leaf_->keys[index_], leaf_->values[index_]);
+        }
+
+        pointer operator->() const {
+            return ArrowProxy(**this);
+        }
+
+        MapIterator& operator++() {
+            if (leaf_ != nullptr && ++index_ == leaf_->count) {
+                leaf_ = leaf_->next;
+                index_ = 0;
+            }
+            return *this;
+        }
+
+        MapIterator operator++(int) {
+            MapIterator tmp = *this;
+            ++(*this);
+            return tmp;
+        }
+
+        MapIterator& operator--() {
+            if (leaf_ == nullptr) {
+                leaf_ = tail_hint_;
+                index_ = leaf_ != nullptr ? leaf_->count - 1 : 0;
+            } else if (index_ == 0) {
+                leaf_ = leaf_->prev;
+                index_ = leaf_ != nullptr ? leaf_->count - 1 : 0;
+            } else {
+                --index_;
+            }
+            return *this;
+        }
+
+        MapIterator operator--(int) {
+            MapIterator tmp = *this;
+            --(*this);
+            return tmp;
+        }
+
+    private:
+        MapIterator(Leaf* leaf, size_t index, Leaf* tail_hint) : leaf_(leaf), index_(index), tail_hint_(tail_hint) {
+        }
+
+        Leaf* leaf_{nullptr};
+        size_t index_{0};
+        Leaf* tail_hint_{nullptr};
+
+        friend class BTreeMap;
+    };
+
+public:
+    BTreeMap() = default;
+
+    BTreeMap(const BTreeMap& other) : comp(other.comp) {
+        if (other.root_ != nullptr) {
+            Leaf* last = nullptr;
+            try {
+                root_ = Clone(other.root_, last);
+            } catch (...) {
+                head_ = nullptr;
+                throw;
+            }
+            tail_ = last;
+            size_ = other.size_;
+        }
+    }
+
+    BTreeMap& operator=(const BTreeMap& other) {
+        if (this != &other) {
+            BTreeMap copy(other);
+            Swap(copy);
+        }
+        return *this;
+    }
+
+    ~BTreeMap() {
+        Clear();
+    }
+
+    MapIterator Begin() const noexcept {
+        return MapIterator(head_, 0, tail_);
+    }
+
+    MapIterator End() const noexcept {
+        return MapIterator(nullptr, 0, tail_);
+    }
+
+    Value& operator[](const Key& key) {
+        auto [it, inserted] = Emplace(key);
+        return it.leaf_->values[it.index_];
+    }
+
+    inline bool IsEmpty() const noexcept {
+        return size_ == 0;
+    }
+
+    inline size_t Size() const noexcept {
+        return size_;
+    }
+
+    void Swap(BTreeMap& a) {
+        static_assert(std::is_same<decltype(this->comp), decltype(a.comp)>::value,
+                      "The compare function types are different");
+        std::swap(root_, a.root_);
+        std::swap(head_, a.head_);
+        std::swap(tail_, a.tail_);
+        std::swap(size_, a.size_);
+        std::swap(comp, a.comp);
+    }
+
+    std::vector<std::pair<const Key, Value>> Values(bool is_increase = true) const {
+        std::vector<std::pair<const Key, Value>> values;
+        values.reserve(size_);
+        if (is_increase) {
+            for (const Leaf* leaf = head_; leaf != nullptr; leaf = leaf->next) {
+                for (size_t i = 0; i < leaf->count; ++i) {
+                    values.emplace_back(leaf->keys[i], leaf->values[i]);
+                }
+            }
+        } else {
+            for (const Leaf* leaf = tail_; leaf != nullptr; leaf = leaf->prev) {
+                for (size_t i = leaf->count; i-- > 0;) {
+                    values.emplace_back(leaf->keys[i], leaf->values[i]);
+                }
+            }
+        }
+        return values;
+    }
+
+    // Overwrites the value if the key is already present
+    void Insert(const std::pair<const Key, Value>& val) {
+        auto [it, inserted] = Emplace(val.first);
+        it.leaf_->values[it.index_] = val.second;
+    }
+
+    void Insert(const std::initializer_list<std::pair<const Key, Value>>& values) {
+        for (const auto& val : values) {
+            Insert(val);
+        }
+    }
+
+    void Erase(const Key& key) {
+        PathEntry path[kMaxDepth];
+        size_t depth = 0;
+        Leaf* leaf = root_ != nullptr ? Descend(key, path, depth) : nullptr;
+        size_t pos = leaf != nullptr ? LowerBound(leaf->keys, leaf->count, key) : 0;
+        if (leaf == nullptr || pos == leaf->count || comp(key, leaf->keys[pos])) {
+            throw std::runtime_error("Value not found");
+        }
+        std::move(leaf->keys + pos + 1, leaf->keys + leaf->count, leaf->keys + pos);
+        std::move(leaf->values + pos + 1, leaf->values + leaf->count, leaf->values + pos);
+        --leaf->count;
+        --size_;
+        RebalanceLeaf(leaf, path, depth);
+    }
+
+    void Clear() noexcept {
+        if (root_ != nullptr) {
+            Destroy(root_);
+        }
+        root_ = nullptr;
+        head_ = tail_ = nullptr;
+        size_ = 0;
+    }
+
+    bool Find(const Key& key) const {
+        MapIterator it = LowerBound(key);
+        return it != End() && !comp(key, it->first);
+    }
+
+    bool Contains(const Key& key) const {
+        return Find(key);
+    }
+
+    // The first entry with a key not less than `key`, End() if there is none
+    MapIterator LowerBound(const Key& key) const {
+        if (root_ == nullptr) {
+            return End();
+        }
+        const Node* node = root_;
+        while (!node->is_leaf) {
+            auto* inner = static_cast<const Inner*>(node);
+            node = inner->children[UpperBound(inner->keys, inner->count, key)];
+        }
+        auto* leaf = const_cast<Leaf*>(static_cast<const Leaf*>(node));
+        size_t pos = LowerBound(leaf->keys, leaf->count, key);
+        if (pos == leaf->count) {
+            // Every key of the leaf is smaller: the answer opens the next leaf
+            return MapIterator(leaf->next, 0, tail_);
+        }
+        return MapIterator(leaf, pos, tail_);
+    }
+
+private:
+    // Finds the slot of `key`, creating it with a default value when missing
+    std::pair<MapIterator, bool> Emplace(const Key& key) {
+        if (root_ == nullptr) {
+            root_ = head_ = tail_ = new Leaf();
+        }
+        PathEntry path[kMaxDepth];
+        size_t depth = 0;
+        Leaf* leaf = Descend(key, path, depth);
+        size_t pos = LowerBound(leaf->keys, leaf->count, key);
+        if (pos < leaf->count && !comp(key, leaf->keys[pos])) {
+            return {MapIterator(leaf, pos, tail_), false};
+        }
+
+        if (leaf->count == kLeafSlots) {
+            Leaf* right = SplitLeaf(leaf);
+            if (pos > leaf->count) {
+                pos -= leaf->count;
+                InsertIntoLeaf(right, pos, key);
+                InsertIntoParent(path, depth, leaf, right->keys[0], right);
+                leaf = right;
+            } else {
+                InsertIntoLeaf(leaf, pos, key);
+                InsertIntoParent(path, depth, leaf, right->keys[0], right);
+            }
+        } else {
+            InsertIntoLeaf(leaf, pos, key);
+        }
+        ++size_;
+        return {MapIterator(leaf, pos, tail_), true};
+    }
+
+    Leaf* Descend(const Key& key, PathEntry* path, size_t& depth) const {
+        Node* node = root_;
+        while (!node->is_leaf) {
+            auto* inner = static_cast<Inner*>(node);
+            size_t index = UpperBound(inner->keys, inner->count, key);
+            path[depth++] = {inner, index};
+            node = inner->children[index];
+        }
+        return static_cast<Leaf*>(node);
+    }
+
+    static void InsertIntoLeaf(Leaf* leaf, size_t pos, const Key& key) {
+        std::move_backward(leaf->keys + pos, leaf->keys + leaf->count, leaf->keys + leaf->count + 1);
+        std::move_backward(leaf->values + pos, leaf->values + leaf->count, leaf->values + leaf->count + 1);
+        leaf->keys[pos] = key;
+        leaf->values[pos] = Value{};
+        ++leaf->count;
+    }
+
+    // Moves the upper half of a full leaf into a new right neighbour
+    Leaf* SplitLeaf(Leaf* leaf) {
+        auto* right = new Leaf();
+        size_t mid = kLeafSlots / 2;
+        std::move(leaf->keys + mid, leaf->keys + kLeafSlots, right->keys);
+        std::move(leaf->values + mid, leaf->values + kLeafSlots, right->values);
+        right->count = static_cast<uint16_t>(kLeafSlots - mid);
+        leaf->count = static_cast<uint16_t>(mid);
+
+        right->prev = leaf;
+        right->next = leaf->next;
+        if (leaf->next != nullptr) {
+            leaf->next->prev = right;
+        } else {
+            tail_ = right;
+        }
+        leaf->next = right;
+        return right;
+    }
+
+    // Hangs `right` after `left` under their parent, splitting full inner nodes up the path
+    void InsertIntoParent(PathEntry* path, size_t depth, Node* left, Key separator, Node* right) {
+        while (depth > 0) {
+            auto [parent, index] = path[--depth];
+            if (parent->count < kInnerSlots) {
+                std::move_backward(parent->keys + index, parent->keys + parent->count,
+                                   parent->keys + parent->count + 1);
+                std::move_backward(parent->children + index + 1, parent->children + parent->count + 1,
+                                   parent->children + parent->count + 2);
+                parent->keys[index] = std::move(separator);
+                parent->children[index + 1] = right;
+                ++parent->count;
+                return;
+            }
+
+            Key keys[kInnerSlots + 1];
+            Node* children[kInnerSlots + 2];
+            std::move(parent->keys, parent->keys + index, keys);
+            keys[index] = std::move(separator);
+            std::move(parent->keys + index, parent->keys + kInnerSlots, keys + index + 1);
+            std::copy(parent->children, parent->children + index + 1, children);
+            children[index + 1] = right;
+            std::copy(parent->children + index + 1, parent->children + kInnerSlots + 1, children + index + 2);
+
+            auto* sibling = new Inner();
+            size_t mid = (kInnerSlots + 1) / 2;
+            std::move(keys, keys + mid, parent->keys);
+            std::copy(children, children + mid + 1, parent->children);
+            parent->count = static_cast<uint16_t>(mid);
+            std::move(keys + mid + 1, keys + kInnerSlots + 1, sibling->keys);
+            std::copy(children + mid + 1, children + kInnerSlots + 2, sibling->children);
+            sibling->count = static_cast<uint16_t>(kInnerSlots - mid);
+
+            left = parent;
+            separator = std::move(keys[mid]);
+            right = sibling;
+        }
+        auto* root = new Inner();
+        root->keys[0] = std::move(separator);
+        root->children[0] = left;
+        root->children[1] = right;
+        root->count = 1;
+        root_ = root;
+    }
+
+    void RebalanceLeaf(Leaf* leaf, PathEntry* path, size_t depth) {
+        if (depth == 0) {
+            if (leaf->count == 0) {
+                delete leaf;
+                root_ = nullptr;
+                head_ = tail_ = nullptr;
+            }
+            return;
+        }
+        if (leaf->count >= kMinLeaf) {
+            return;
+        }
+        auto [parent, index] = path[depth - 1];
+        auto* left = index > 0 ? static_cast<Leaf*>(parent->children[index - 1]) : nullptr;
+        auto* right = index < parent->count ? static_cast<Leaf*>(parent->children[index + 1]) : nullptr;
+
+        if (left != nullptr && left->count > kMinLeaf) {
+            std::move_backward(leaf->keys, leaf->keys + leaf->count, leaf->keys + leaf->count + 1);
+            std::move_backward(leaf->values, leaf->values + leaf->count, leaf->values + leaf->count + 1);
+            --left->count;
+            leaf->keys[0] = std::move(left->keys[left->count]);
+            leaf->values[0] = std::move(left->values[left->count]);
+            ++leaf->count;
+            parent->keys[index - 1] = leaf->keys[0];
+            return;
+        }
+        if (right != nullptr && right->count > kMinLeaf) {
+            leaf->keys[leaf->count] = std::move(right->keys[0]);
+            leaf->values[leaf->count] = std::move(right->values[0]);
+            ++leaf->count;
+            std::move(right->keys + 1, right->keys + right->count, right->keys);
+            std::move(right->values + 1, right->values + right->count, right->values);
+            --right->count;
+            parent->keys[index] = right->keys[0];
+            return;
+        }
+
+        if (left != nullptr) {
+            MergeLeaves(left, leaf);
+            RemoveFromInner(parent, index - 1);
+        } else {
+            MergeLeaves(leaf, right);
+            RemoveFromInner(parent, index);
+        }
+        RebalanceInner(parent, path, depth - 1);
+    }
+
+    // Appends `right` to `left` and drops it
+    void MergeLeaves(Leaf* left, Leaf* right) {
+        std::move(right->keys, right->keys + right->count, left->keys + left->count);
+        std::move(right->values, right->values + right->count, left->values + left->count);
+        left->count = static_cast<uint16_t>(left->count + right->count);
+        left->next = right->next;
+        if (right->next != nullptr) {
+            right->next->prev = left;
+        } else {
+            tail_ = left;
+        }
+        delete right;
+    }
+
+    // Removes keys[index] and the child to its right
+    static void RemoveFromInner(Inner* node, size_t index) {
+        std::move(node->keys + index + 1, node->keys + node->count, node->keys + index);
+        std::copy(node->children + index + 2, node->children + node->count + 1, node->children + index + 1);
+        --node->count;
+    }
+
+    void RebalanceInner(Inner* node, PathEntry* path, size_t depth) {
+        if (depth == 0) {
+            if (node->count == 0) {
+                root_ = node->children[0];
+                delete node;
+            }
+            return;
+        }
+        if (node->count >= kMinInner) {
+            return;
+        }
+        auto [parent, index] = path[depth - 1];
+        auto* left = index > 0 ? static_cast<Inner*>(parent->children[index - 1]) : nullptr;
+        auto* right = index < parent->count ? static_cast<Inner*>(parent->children[index + 1]) : nullptr;
+
+        if (left != nullptr && left->count > kMinInner) {
+            std::move_backward(node->keys, node->keys + node->count, node->keys + node->count + 1);
+            std::copy_backward(node->children, node->children + node->count + 1, node->children + node->count + 2);
+            node->keys[0] = std::move(parent->keys[index - 1]);
+            node->children[0] = left->children[left->count];
+            parent->keys[index - 1] = std::move(left->keys[left->count - 1]);
+            --left->count;
+            ++node->count;
+            return;
+        }
+        if (right != nullptr && right->count > kMinInner) {
+            node->keys[node->count] = std::move(parent->keys[index]);
+            node->children[node->count + 1] = right->children[0];
+            ++node->count;
+            parent->keys[index] = std::move(right->keys[0]);
+            std::move(right->keys + 1, right->keys + right->count, right->keys);
+            std::copy(right->children + 1, right->children + right->count + 1, right->children);
+            --right->count;
+            return;
+        }
+
+        if (left != nullptr) {
+            MergeInner(left, parent->keys[index - 1], node);
+            RemoveFromInner(parent, index - 1);
+        } else {
+            MergeInner(node, parent->keys[index], right);
+            RemoveFromInner(parent, index);
+        }
+        RebalanceInner(parent, path, depth - 1);
+    }
+
+    // Pulls the separator down between `left` and `right`, then drops `right`
+    static void MergeInner(Inner* left, Key& separator, Inner* right) {
+        left->keys[left->count] = std::move(separator);
+        std::move(right->keys, right->keys + right->count, left->keys + left->count + 1);
+        std::copy(right->children, right->children + right->count + 1, left->children + left->count + 1);
+        left->count = static_cast<uint16_t>(left->count + 1 + right->count);
+        delete right;
+    }
+
+    static void Destroy(Node* node) noexcept {
+        if (!node->is_leaf) {
+            auto* inner = static_cast<Inner*>(node);
+            for (size_t i = 0; i <= inner->count; ++i) {
+                Destroy(inner->children[i]);
+            }
+            delete inner;
+        } else {
+            delete static_cast<Leaf*>(node);
+        }
+    }
+
+    // Copies the subtree and threads its leaves after `last`. On failure nothing of the copy
+    // stays allocated, though head_ and `last` may point to freed leaves.
+    Node* Clone(const Node* node, Leaf*& last) {
+        if (node->is_leaf) {
+            auto* src = static_cast<const Leaf*>(node);
+            auto* leaf = new Leaf();
+            try {
+                std::copy(src->keys, src->keys + src->count, leaf->keys);
+                std::copy(src->values, src->values + src->count, leaf->values);
+            } catch (...) {
+                delete leaf;
+                throw;
+            }
+            leaf->count = src->count;
+            leaf->prev = last;
+            if (last != nullptr) {
+                last->next = leaf;
+            } else {
+                head_ = leaf;
+            }
+            last = leaf;
+            return leaf;
+        }
+        auto* src = static_cast<const Inner*>(node);
+        auto* inner = new Inner();
+        size_t cloned = 0;
+        try {
+            std::copy(src->keys, src->keys + src->count, inner->keys);
+            for (; cloned <= src->count; ++cloned) {
+                inner->children[cloned] = Clone(src->children[cloned], last);
+            }
+        } catch (...) {
+            for (size_t i = 0; i < cloned; ++i) {
+                Destroy(inner->children[i]);
+            }
+            delete inner;
+            throw;
+        }
+        inner->count = src->count;
+        return inner;
+    }
+
+    // Index of the first key in keys[0, count) that is not less than `key`
+    size_t LowerBound(const Key* keys, size_t count, const Key& key) const {
+        if constexpr (kSimdSearch) {
+            return SimdCount<false>(keys, count, key);
+        } else {
+            return static_cast<size_t>(std::partition_point(keys, keys + count,
+                                                            [&](const Key& k) { return comp(k, key); }) -
+                                       keys);
+        }
+    }
+
+    // Index of the first key in keys[0, count) that is greater than `key`
+    size_t UpperBound(const Key* keys, size_t count, const Key& key) const {
+        if constexpr (kSimdSearch) {
+            return SimdCount<true>(keys, count, key);
+        } else {
+            return static_cast<size_t>(std::partition_point(keys, keys + count,
+                                                            [&](const Key& k) { return !comp(key, k); }) -
+                                       keys);
+        }
+    }
+
+#if defined(__SSE2__)
+    // Counts keys below `key` (or not above it) one 16-byte block at a time
+    template <bool kOrEqual>
+    static size_t SimdCount(const Key* keys, size_t count, Key key) noexcept {
+        constexpr size_t kLanes = 16 / sizeof(Key);
+        const __m128i flip = SimdFlip();
+        __m128i needle;
+        if constexpr (sizeof(Key) == 4) {
+            needle = _mm_xor_si128(_mm_set1_epi32(static_cast<int32_t>(key)), flip);
+        } else {
+            needle = _mm_xor_si128(_mm_set1_epi64x(static_cast<int64_t>(key)), flip);
+        }
+        size_t result = 0;
+        size_t i = 0;
+        for (; i + kLanes <= count; i += kLanes) {
+            __m128i block = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + i)), flip);
+            __m128i mask = kOrEqual ? SimdGreater(block, needle) : SimdGreater(needle, block);
+            result += static_cast<size_t>(std::popcount(SimdLaneBits(mask)));
+        }
+        if constexpr (kOrEqual) {
+            result = i - result;
+        }
+        for (; i < count && (kOrEqual ? !(key < keys[i]) : keys[i] < key); ++i) {
+            ++result;
+        }
+        return result;
+    }
+
+    // Makes the signed SSE2 comparison of 32-bit halves order the keys: unsigned keys get their
+    // sign bit flipped, and so does the low half of a 64-bit key, which compares as unsigned
+    static __m128i SimdFlip() noexcept {
+        constexpr int32_t kHigh = std::is_signed_v<Key> ? 0 : INT32_MIN;
+        if constexpr (sizeof(Key) == 4) {
+            return _mm_set1_epi32(kHigh);
+        } else {
+            return _mm_set_epi32(kHigh, INT32_MIN, kHigh, INT32_MIN);
+        }
+    }
+
+    // All-ones lanes where a > b. SSE2 has no 64-bit comparison: a 64-bit lane is greater if its
+    // high half is, or if the high halves are equal and the low half is.
+    static __m128i SimdGreater(__m128i a, __m128i b) noexcept {
+        __m128i greater = _mm_cmpgt_epi32(a, b);
+        if constexpr (sizeof(Key) == 4) {
+            return greater;
+        } else {
+            __m128i low_greater = _mm_shuffle_epi32(greater, _MM_SHUFFLE(2, 2, 0, 0));
+            return _mm_or_si128(greater, _mm_and_si128(_mm_cmpeq_epi32(a, b), low_greater));
+        }
+    }
+
+    // One bit per lane of `mask`, taken from the top bit of the lane
+    static unsigned SimdLaneBits(__m128i mask) noexcept {
+        if constexpr (sizeof(Key) == 4) {
+            return static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(mask)));
+        } else {
+            return static_cast<unsigned>(_mm_movemask_pd(_mm_castsi128_pd(mask)));
+        }
+    }
+#endif
+
+private:
+    Compare comp;
+    Node* root_{nullptr};
+    Leaf* head_{nullptr};
+    Leaf* tail_{nullptr};
+    size_t size_{0};
+};
+
+namespace std {
+// Global swap overloading
+template <typename Key, typename Value, typename Compare>
+void swap(BTreeMap<Key, Value, Compare>& a, BTreeMap<Key, Value, Compare>& b) {  // NOLINT
+    a.Swap(b);
+}
+}  // namespace std
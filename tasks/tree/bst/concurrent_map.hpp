@@ -0,0 +1,376 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <new>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <ebr/domain.hpp>
+
+// Ordered dictionary for many threads: a lock-free skip list (Herlihy-Shavit) with epoch-based
+// reclamation. Insert, Erase, Find and Get take expected O(log n) and never block one another;
+// Find, Get and Values do not even write to shared memory. Requires linking the ebr library.
+//
+// A node is removed by setting the low bit of its forward links, top level first; the level-0
+// bit decides which thread removed it. Searches unlink marked nodes they pass. A removed node
+// is retired only when both its inserter and its remover are done with it, so an insertion
+// still linking upper levels cannot leave it reachable after it is freed.
+//
+// Values are replaced, not written in place: Insert over a present key swaps in a new value
+// and retires the old one, so a reader's copy is never torn. For the same reason there is no
+// operator[]; use Get, which returns a copy.
+template <typename Key, typename Value, typename Compare = std::less<Key>>
+class ConcurrentMap {
+private:
+    static constexpr size_t kMaxHeight = 24;
+
+    // Node pointer in the high bits, "this node is removed at this level" in bit 0
+    using Link = std::atomic<uintptr_t>;
+
+    struct Node {
+        const Key key;
+        std::atomic<Value*> value;
+        // Inserter and remover; the last one to let go retires the node
+        std::atomic<int> owners{2};
+        size_t height;
+
+        Node(const Key& k, Value* v, size_t h) : key(k), value(v), height(h) {
+        }
+
+        // The tower of `height` links follows the node in the same allocation
+        Link* Tower() noexcept {
+            return reinterpret_cast<Link*>(this + 1);
+        }
+    };
+
+    static_assert(alignof(Node) >= alignof(Link));
+
+    static Node* Pointer(uintptr_t link) noexcept {
+        return reinterpret_cast<Node*>(link & ~uintptr_t{1});
+    }
+
+    static bool Marked(uintptr_t link) noexcept {
+        return (link & 1) != 0;
+    }
+
+    static uintptr_t Word(Node* node) noexcept {
+        return reinterpret_cast<uintptr_t>(node);
+    }
+
+public:
+    ConcurrentMap() {
+        for (auto& link : head_) {
+            link.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    ConcurrentMap(const ConcurrentMap&) = delete;
+    ConcurrentMap& operator=(const ConcurrentMap&) = delete;
+
+    // No other thread may use the map any more
+    ~ConcurrentMap() {
+        Node* node = Pointer(head_[0].load(std::memory_order_acquire));
+        while (node != nullptr) {
+            Node* next = Pointer(node->Tower()[0].load(std::memory_order_relaxed));
+            DestroyNode(node);
+            node = next;
+        }
+    }
+
+    // Approximate while other threads modify the map
+    bool IsEmpty() const noexcept {
+        return Size() == 0;
+    }
+
+    size_t Size() const noexcept {
+        return size_.load(std::memory_order_relaxed);
+    }
+
+    // Overwrites the value if the key is already present
+    void Insert(const std::pair<const Key, Value>& val) {
+        ebr::Guard guard(domain_);
+        Link* preds[kMaxHeight];
+        Node* succs[kMaxHeight];
+        Node* node = nullptr;
+        while (true) {
+            if (Search(val.first, preds, succs)) {
+                Value* old = succs[0]->value.exchange(new Value(val.second), std::memory_order_acq_rel);
+                domain_.Retire(old);
+                if (node != nullptr) {
+                    DestroyNode(node);  // Never published
+                }
+                return;
+            }
+            if (node == nullptr) {
+                node = NewNode(val.first, val.second, RandomHeight());
+            }
+            for (size_t level = 0; level < node->height; ++level) {
+                node->Tower()[level].store(Word(succs[level]), std::memory_order_relaxed);
+            }
+            uintptr_t expected = Word(succs[0]);
+            if (preds[0][0].compare_exchange_strong(expected, Word(node), std::memory_order_release,
+                                                    std::memory_order_relaxed)) {
+                break;
+            }
+        }
+        size_.fetch_add(1, std::memory_order_relaxed);
+        LinkUpperLevels(node, preds, succs);
+        ReleaseOwner(node);
+    }
+
+    void Insert(const std::initializer_list<std::pair<const Key, Value>>& values) {
+        for (const auto& val : values) {
+            Insert(val);
+        }
+    }
+
+    void Erase(const Key& key) {
+        if (!Remove(key)) {
+            throw std::runtime_error("Value not found");
+        }
+    }
+
+    // Removes entries one by one; entries inserted meanwhile may survive
+    void Clear() {
+        while (true) {
+            std::optional<Key> first;
+            {
+                ebr::Guard guard(domain_);
+                Node* node = FirstLive();
+                if (node == nullptr) {
+                    return;
+                }
+                first.emplace(node->key);
+            }
+            Remove(*first);
+        }
+    }
+
+    bool Find(const Key& key) const {
+        ebr::Guard guard(domain_);
+        return FindLive(key) != nullptr;
+    }
+
+    std::optional<Value> Get(const Key& key) const {
+        ebr::Guard guard(domain_);
+        Node* node = FindLive(key);
+        if (node == nullptr) {
+            return std::nullopt;
+        }
+        return *node->value.load(std::memory_order_acquire);
+    }
+
+    // Entries present for the whole walk are all included; concurrent changes may or may not be
+    std::vector<std::pair<const Key, Value>> Values(bool is_increase = true) const {
+        std::vector<std::pair<const Key, Value>> values;
+        {
+            ebr::Guard guard(domain_);
+            for (Node* node = Pointer(head_[0].load(std::memory_order_acquire)); node != nullptr;) {
+                uintptr_t next = node->Tower()[0].load(std::memory_order_acquire);
+                if (!Marked(next)) {
+                    values.emplace_back(node->key, *node->value.load(std::memory_order_acquire));
+                }
+                node = Pointer(next);
+            }
+        }
+        if (!is_increase) {
+            // pair<const Key, Value> is not assignable, so build the reversed copy
+            return {std::make_move_iterator(values.rbegin()), std::make_move_iterator(values.rend())};
+        }
+        return values;
+    }
+
+private:
+    static Node* NewNode(const Key& key, const Value& value, size_t height) {
+        void* memory = ::operator new(sizeof(Node) + height * sizeof(Link), std::align_val_t{alignof(Node)});
+        Value* stored = nullptr;
+        try {
+            stored = new Value(value);
+            auto* node = new (memory) Node(key, stored, height);
+            for (size_t level = 0; level < height; ++level) {
+                new (node->Tower() + level) Link(0);
+            }
+            return node;
+        } catch (...) {
+            delete stored;
+            ::operator delete(memory, std::align_val_t{alignof(Node)});
+            throw;
+        }
+    }
+
+    static void DestroyNode(void* ptr) noexcept {
+        auto* node = static_cast<Node*>(ptr);
+        delete node->value.load(std::memory_order_relaxed);
+        node->~Node();
+        ::operator delete(ptr, std::align_val_t{alignof(Node)});
+    }
+
+    void ReleaseOwner(Node* node) {
+        if (node->owners.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            domain_.Retire(node, &DestroyNode);
+        }
+    }
+
+    // Geometric with p = 1/4, as in SkipList
+    static size_t RandomHeight() {
+        thread_local std::mt19937_64 random(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+        uint64_t bits = random() | (uint64_t{1} << (2 * (kMaxHeight - 1)));
+        return static_cast<size_t>(std::countr_zero(bits)) / 2 + 1;
+    }
+
+    // Fills, for every level, the tower whose link should point to `key` and the node that
+    // link currently holds, unlinking marked nodes on the way. True if an unmarked node with
+    // `key` was found (it is succs[0]).
+    bool Search(const Key& key, Link** preds, Node** succs) {
+        while (true) {
+            if (auto found = TrySearch(key, preds, succs)) {
+                return *found;
+            }
+        }
+    }
+
+    // std::nullopt if a predecessor changed under us and the search has to start over
+    std::optional<bool> TrySearch(const Key& key, Link** preds, Node** succs) {
+        Link* pred = head_;
+        for (size_t level = kMaxHeight; level-- > 0;) {
+            uintptr_t link = pred[level].load(std::memory_order_acquire);
+            if (Marked(link)) {
+                return std::nullopt;  // pred itself got removed
+            }
+            Node* curr = Pointer(link);
+            while (curr != nullptr) {
+                uintptr_t next = curr->Tower()[level].load(std::memory_order_acquire);
+                if (Marked(next)) {
+                    uintptr_t expected = Word(curr);
+                    if (!pred[level].compare_exchange_strong(expected, next & ~uintptr_t{1},
+                                                             std::memory_order_acq_rel,
+                                                             std::memory_order_relaxed)) {
+                        return std::nullopt;
+                    }
+                    curr = Pointer(next);
+                    continue;
+                }
+                if (!comp_(curr->key, key)) {
+                    break;
+                }
+                pred = curr->Tower();
+                curr = Pointer(next);
+            }
+            preds[level] = pred;
+            succs[level] = curr;
+        }
+        return succs[0] != nullptr && !comp_(key, succs[0]->key);
+    }
+
+    // Wait-free lookup: skips marked nodes instead of unlinking them
+    Node* FindLive(const Key& key) const {
+        const Link* pred = head_;
+        Node* curr = nullptr;
+        for (size_t level = kMaxHeight; level-- > 0;) {
+            curr = Pointer(pred[level].load(std::memory_order_acquire));
+            while (curr != nullptr) {
+                uintptr_t next = curr->Tower()[level].load(std::memory_order_acquire);
+                if (!Marked(next) && !comp_(curr->key, key)) {
+                    break;
+                }
+                if (!Marked(next)) {
+                    pred = curr->Tower();
+                }
+                curr = Pointer(next);
+            }
+        }
+        if (curr == nullptr || comp_(key, curr->key) || Marked(curr->Tower()[0].load(std::memory_order_acquire))) {
+            return nullptr;
+        }
+        return curr;
+    }
+
+    Node* FirstLive() const {
+        Node* node = Pointer(head_[0].load(std::memory_order_acquire));
+        while (node != nullptr) {
+            uintptr_t next = node->Tower()[0].load(std::memory_order_acquire);
+            if (!Marked(next)) {
+                return node;
+            }
+            node = Pointer(next);
+        }
+        return nullptr;
+    }
+
+    void LinkUpperLevels(Node* node, Link** preds, Node** succs) {
+        for (size_t level = 1; level < node->height && LinkLevel(node, level, preds, succs); ++level) {
+        }
+        // A remover may have searched before some of our links appeared: unlink them ourselves
+        if (Marked(node->Tower()[0].load(std::memory_order_acquire))) {
+            Search(node->key, preds, succs);
+        }
+    }
+
+    // False if the node got removed before it could be linked at `level`
+    bool LinkLevel(Node* node, size_t level, Link** preds, Node** succs) {
+        while (true) {
+            // Point the node at its successor unless a remover has marked the link already
+            uintptr_t own = node->Tower()[level].load(std::memory_order_acquire);
+            if (Marked(own)) {
+                return false;
+            }
+            if (own != Word(succs[level]) &&
+                !node->Tower()[level].compare_exchange_strong(own, Word(succs[level]), std::memory_order_acq_rel)) {
+                return false;
+            }
+            uintptr_t expected = Word(succs[level]);
+            if (preds[level][level].compare_exchange_strong(expected, Word(node), std::memory_order_release,
+                                                            std::memory_order_relaxed)) {
+                return true;
+            }
+            if (!Search(node->key, preds, succs) || succs[0] != node) {
+                return false;
+            }
+        }
+    }
+
+    bool Remove(const Key& key) {
+        ebr::Guard guard(domain_);
+        Link* preds[kMaxHeight];
+        Node* succs[kMaxHeight];
+        if (!Search(key, preds, succs)) {
+            return false;
+        }
+        Node* victim = succs[0];
+        for (size_t level = victim->height; level-- > 1;) {
+            uintptr_t link = victim->Tower()[level].load(std::memory_order_acquire);
+            while (!Marked(link) &&
+                   !victim->Tower()[level].compare_exchange_weak(link, link | 1, std::memory_order_acq_rel)) {
+            }
+        }
+        uintptr_t link = victim->Tower()[0].load(std::memory_order_acquire);
+        while (true) {
+            if (Marked(link)) {
+                return false;  // Another thread removed it first
+            }
+            if (victim->Tower()[0].compare_exchange_weak(link, link | 1, std::memory_order_acq_rel)) {
+                break;
+            }
+        }
+        size_.fetch_sub(1, std::memory_order_relaxed);
+        Search(key, preds, succs);
+        ReleaseOwner(victim);
+        return true;
+    }
+
+private:
+    // Mutable: readers enter guards of the domain, which registers the calling thread
+    mutable ebr::Domain domain_;
+    Link head_[kMaxHeight];
+    std::atomic<size_t> size_{0};
+    Compare comp_;
+};
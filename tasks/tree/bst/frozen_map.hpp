@@ -0,0 +1,265 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "map.hpp"
+
+// Read-only dictionary for tables built once and queried many times.
+//
+// Keys are laid out in Eytzinger (BFS) order in one array: the children of slot k are 2k and
+// 2k + 1, so the top levels of the search share a few cache lines. The search is branchless and
+// prefetches the 16-ary subtree four levels ahead, which keeps several cache misses in flight
+// instead of waiting for each level in turn. Values sit in a parallel array and are only touched
+// once the key is found.
+template <typename Key, typename Value, typename Compare = std::less<Key>>
+class FrozenMap {
+public:
+    class MapIterator {
+    public:
+        // NOLINTNEXTLINE
+        using value_type = std::pair<const Key, Value>;
+        // NOLINTNEXTLINE
+        using reference = std::pair<const Key&, const Value&>;
+        // NOLINTNEXTLINE
+        using difference_type = std::ptrdiff_t;
+        // NOLINTNEXTLINE
+        using iterator_category = std::bidirectional_iterator_tag;
+
+        // Keys and values are stored apart, so `->` goes through a pair of references
+        class ArrowProxy {
+        public:
+            const reference* operator->() const noexcept {
+                return &ref_;
+            }
+
+        private:
+            explicit ArrowProxy(reference ref) : ref_(ref) {
+            }
+
+            reference ref_;
+
+            friend class MapIterator;
+        };
+
+        // NOLINTNEXTLINE
+        using pointer = ArrowProxy;
+
+        MapIterator() = default;
+
+        bool operator==(const MapIterator& other) const {
+            return slot_ == other.slot_;
+        }
+
+        bool operator!=(const MapIterator& other) const {
+            return !(*this == other);
+        }
+
+        reference operator*() const {
+            if (slot_ == 0) {
+                throw std::runtime_error("Dereferencing end iterator");
+            }
+            return reference(owner_->keys_[slot_], owner_->values_[slot_]);
+        }
+
+        pointer operator->() const {
+            return ArrowProxy(**this);
+        }
+
+        // In-order successor in the implicit tree: leftmost slot of the right subtree, or up past
+        // every right-child step, then one more
+        MapIterator& operator++() {
+            if (slot_ != 0) {
+                size_t size = owner_->Size();
+                if (2 * slot_ + 1 <= size) {
+                    slot_ = owner_->Leftmost(2 * slot_ + 1);
+                } else {
+                    slot_ >>= std::countr_one(slot_) + 1;
+                }
+            }
+            return *this;
+        }
+
+        MapIterator operator++(int) {
+            MapIterator tmp = *this;
+            ++(*this);
+            return tmp;
+        }
+
+        // Stepping back from the end lands on the last entry
+        MapIterator& operator--() {
+            size_t size = owner_->Size();
+            if (slot_ == 0) {
+                slot_ = owner_->Rightmost(1);
+            } else if (2 * slot_ <= size) {
+                slot_ = owner_->Rightmost(2 * slot_);
+            } else {
+                slot_ >>= std::countr_zero(slot_) + 1;
+            }
+            return *this;
+        }
+
+        MapIterator operator--(int) {
+            MapIterator tmp = *this;
+            --(*this);
+            return tmp;
+        }
+
+    private:
+        MapIterator(size_t slot, const FrozenMap* owner) : slot_(slot), owner_(owner) {
+        }
+
+        // Eytzinger slot, from 1; 0 is the end
+        size_t slot_{0};
+        const FrozenMap* owner_{nullptr};
+
+        friend class FrozenMap;
+    };
+
+    FrozenMap() = default;
+
+    template <typename Balance, typename Augment>
+    explicit FrozenMap(const Map<Key, Value, Compare, Balance, Augment>& map) {
+        std::vector<std::pair<Key, Value>> entries;
+        entries.reserve(map.Size());
+        for (const auto& entry : map.Ascending()) {
+            entries.emplace_back(entry);
+        }
+        Lay(entries);
+    }
+
+    // Entries must be sorted by key; of equal keys the last one wins, as with repeated Insert.
+    // Throws std::runtime_error if the input is out of order.
+    template <typename It>
+        requires std::input_iterator<It>
+    static FrozenMap BuildFromSorted(It first, It last) {
+        FrozenMap map;
+        std::vector<std::pair<Key, Value>> entries;
+        for (; first != last; ++first) {
+            if (!entries.empty()) {
+                if (map.comp_(first->first, entries.back().first)) {
+                    throw std::runtime_error("Input is not sorted");
+                }
+                if (!map.comp_(entries.back().first, first->first)) {
+                    entries.back().second = first->second;
+                    continue;
+                }
+            }
+            entries.emplace_back(*first);
+        }
+        map.Lay(entries);
+        return map;
+    }
+
+    inline bool IsEmpty() const noexcept {
+        return Size() == 0;
+    }
+
+    inline size_t Size() const noexcept {
+        return keys_.empty() ? 0 : keys_.size() - 1;
+    }
+
+    MapIterator Begin() const noexcept {
+        return MapIterator(Leftmost(1), this);
+    }
+
+    MapIterator End() const noexcept {
+        return MapIterator(0, this);
+    }
+
+    bool Find(const Key& key) const {
+        return Contains(key);
+    }
+
+    bool Contains(const Key& key) const {
+        size_t slot = LowerBoundSlot(key);
+        return slot != 0 && !comp_(key, keys_[slot]);
+    }
+
+    // First entry whose key is not less than `key`
+    MapIterator LowerBound(const Key& key) const {
+        return MapIterator(LowerBoundSlot(key), this);
+    }
+
+private:
+    // How far ahead the search prefetches: the 2^4 descendants of a slot four levels down are
+    // adjacent, one cache line of `int` keys
+    static constexpr size_t kPrefetchLevels = 4;
+
+    // Puts the sorted entries into the slots in BFS order of the implicit tree. Slot 0 is padding
+    // so that the children of slot k are 2k and 2k + 1.
+    void Lay(std::vector<std::pair<Key, Value>>& entries) {
+        if (entries.empty()) {
+            return;
+        }
+        size_t size = entries.size();
+        std::vector<size_t> order(size + 1);
+        size_t next = 0;
+        Number(1, size, order, next);
+
+        keys_.reserve(size + 1);
+        values_.reserve(size + 1);
+        keys_.push_back(entries[0].first);
+        values_.push_back(entries[0].second);
+        for (size_t slot = 1; slot <= size; ++slot) {
+            keys_.push_back(std::move(entries[order[slot]].first));
+            values_.push_back(std::move(entries[order[slot]].second));
+        }
+    }
+
+    // Assigns in-order positions to the subtree at `slot`; the recursion is only log n deep
+    static void Number(size_t slot, size_t size, std::vector<size_t>& order, size_t& next) {
+        if (slot > size) {
+            return;
+        }
+        Number(2 * slot, size, order, next);
+        order[slot] = next++;
+        Number(2 * slot + 1, size, order, next);
+    }
+
+    // Descends without branches: every step goes to 2k or 2k + 1 by the comparison result.
+    // The path ends past the leaves; the trailing ones of the final index are the right turns
+    // taken since the last left turn, and undoing them lands on the lower bound.
+    size_t LowerBoundSlot(const Key& key) const {
+        size_t size = Size();
+        const Key* keys = keys_.data();
+        size_t slot = 1;
+        while (slot <= size) {
+            __builtin_prefetch(keys + std::min(slot << kPrefetchLevels, size));
+            slot = 2 * slot + static_cast<size_t>(comp_(keys[slot], key));
+        }
+        return slot >> (std::countr_one(slot) + 1);
+    }
+
+    size_t Leftmost(size_t slot) const noexcept {
+        size_t size = Size();
+        if (slot > size) {
+            return 0;
+        }
+        while (2 * slot <= size) {
+            slot *= 2;
+        }
+        return slot;
+    }
+
+    size_t Rightmost(size_t slot) const noexcept {
+        size_t size = Size();
+        if (slot > size) {
+            return 0;
+        }
+        while (2 * slot + 1 <= size) {
+            slot = 2 * slot + 1;
+        }
+        return slot;
+    }
+
+    std::vector<Key> keys_;
+    std::vector<Value> values_;
+    Compare comp_;
+};
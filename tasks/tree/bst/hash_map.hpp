@@ -0,0 +1,423 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Unordered dictionary with the Map interface: an open-addressing hash table in the style of
+// Swiss tables.
+//
+// Entries live in one flat array of slots. Next to it, a control byte per slot says whether the
+// slot is empty, deleted, or full, and for a full slot holds 7 bits of the key's hash. A lookup
+// loads a group of 16 control bytes at once and compares them all against those 7 bits
+// (one SSE2 instruction), so only slots whose bits match have their keys compared. Groups are
+// probed quadratically; the table grows at 7/8 load.
+//
+// Insert and Erase keep other entries in place, but growing the table moves them all.
+template <typename Key, typename Value, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+class HashMap {
+private:
+    using Slot = std::pair<const Key, Value>;
+    using Ctrl = int8_t;
+
+    static constexpr Ctrl kEmpty = -128;
+    static constexpr Ctrl kDeleted = -2;
+    // Marks the end of the slots for the group loads that run past it
+    static constexpr Ctrl kSentinel = -1;
+
+    static constexpr size_t kGroupWidth = 16;
+    static constexpr size_t kMinCapacity = kGroupWidth - 1;
+    static constexpr size_t kAlignment = std::max(alignof(Slot), kGroupWidth);
+
+    // Matches over the 16 control bytes starting at `ctrl`, as bit masks: bit i is byte i
+    class Group {
+    public:
+        explicit Group(const Ctrl* ctrl) noexcept {
+#if defined(__SSE2__)
+            bytes_ = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl));
+#else
+            std::memcpy(bytes_, ctrl, kGroupWidth);
+#endif
+        }
+
+        uint32_t Match(Ctrl h2) const noexcept {
+#if defined(__SSE2__)
+            return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), bytes_)));
+#else
+            uint32_t mask = 0;
+            for (size_t i = 0; i < kGroupWidth; ++i) {
+                mask |= static_cast<uint32_t>(bytes_[i] == h2) << i;
+            }
+            return mask;
+#endif
+        }
+
+        uint32_t MatchEmpty() const noexcept {
+            return Match(kEmpty);
+        }
+
+        // Empty and deleted are the only control values below the sentinel
+        uint32_t MatchEmptyOrDeleted() const noexcept {
+#if defined(__SSE2__)
+            return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(kSentinel), bytes_)));
+#else
+            uint32_t mask = 0;
+            for (size_t i = 0; i < kGroupWidth; ++i) {
+                mask |= static_cast<uint32_t>(bytes_[i] < kSentinel) << i;
+            }
+            return mask;
+#endif
+        }
+
+    private:
+#if defined(__SSE2__)
+        __m128i bytes_;
+#else
+        Ctrl bytes_[kGroupWidth];
+#endif
+    };
+
+public:
+    HashMap() = default;
+
+    HashMap(const HashMap& other) : hash_(other.hash_), equal_(other.equal_) {
+        Reserve(other.size_);
+        other.ForEachSlot([this](const Slot& slot) { InsertNew(slot); });
+    }
+
+    HashMap& operator=(const HashMap& other) {
+        if (this != &other) {
+            HashMap copy(other);
+            Swap(copy);
+        }
+        return *this;
+    }
+
+    HashMap(HashMap&& other) noexcept {
+        Swap(other);
+    }
+
+    HashMap& operator=(HashMap&& other) noexcept {
+        if (this != &other) {
+            HashMap empty;
+            Swap(empty);
+            Swap(other);
+        }
+        return *this;
+    }
+
+    Value& operator[](const Key& key) {
+        size_t hash = HashOf(key);
+        size_t index = FindIndex(key, hash);
+        if (index == kNotFound) {
+            index = PrepareInsert(hash);
+            new (slots_ + index) Slot(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple());
+            Publish(index, hash);
+        }
+        return slots_[index].second;
+    }
+
+    inline bool IsEmpty() const noexcept {
+        return size_ == 0;
+    }
+
+    inline size_t Size() const noexcept {
+        return size_;
+    }
+
+    // Number of entries the table holds before it has to grow
+    size_t Capacity() const noexcept {
+        return MaxLoad(capacity_);
+    }
+
+    // Grows the table up front so that `count` entries fit without rehashing
+    void Reserve(size_t count) {
+        if (MaxLoad(capacity_) >= count) {
+            return;
+        }
+        size_t capacity = std::max(capacity_, kMinCapacity);
+        while (MaxLoad(capacity) < count) {
+            capacity = capacity * 2 + 1;
+        }
+        Resize(capacity);
+    }
+
+    void Swap(HashMap& a) noexcept {
+        std::swap(ctrl_, a.ctrl_);
+        std::swap(slots_, a.slots_);
+        std::swap(capacity_, a.capacity_);
+        std::swap(size_, a.size_);
+        std::swap(growth_left_, a.growth_left_);
+        std::swap(hash_, a.hash_);
+        std::swap(equal_, a.equal_);
+    }
+
+    // In no particular order
+    std::vector<std::pair<const Key, Value>> Values() const {
+        std::vector<std::pair<const Key, Value>> values;
+        values.reserve(size_);
+        ForEachSlot([&values](const Slot& slot) { values.push_back(slot); });
+        return values;
+    }
+
+    // Overwrites the value if the key is already present
+    void Insert(const std::pair<const Key, Value>& val) {
+        size_t hash = HashOf(val.first);
+        size_t index = FindIndex(val.first, hash);
+        if (index != kNotFound) {
+            slots_[index].second = val.second;
+            return;
+        }
+        index = PrepareInsert(hash);
+        new (slots_ + index) Slot(val);
+        Publish(index, hash);
+    }
+
+    void Insert(const std::initializer_list<std::pair<const Key, Value>>& values) {
+        for (const auto& val : values) {
+            Insert(val);
+        }
+    }
+
+    void Erase(const Key& key) {
+        size_t index = FindIndex(key, HashOf(key));
+        if (index == kNotFound) {
+            throw std::runtime_error("Value not found");
+        }
+        std::destroy_at(slots_ + index);
+        --size_;
+        // A probe stops at the first empty byte of a group. If no group around this slot was ever
+        // full, no probe ever went past it, and the slot can become empty instead of deleted.
+        size_t before = (index - kGroupWidth) & capacity_;
+        uint32_t empty_after = Group(ctrl_ + index).MatchEmpty();
+        uint32_t empty_before = Group(ctrl_ + before).MatchEmpty();
+        bool was_never_full = empty_after != 0 && empty_before != 0 &&
+                              static_cast<size_t>(std::countr_zero(empty_after) + std::countl_zero(empty_before << 16)) < kGroupWidth;
+        SetCtrl(index, was_never_full ? kEmpty : kDeleted);
+        if (was_never_full) {
+            ++growth_left_;
+        }
+    }
+
+    // Destroys the entries but keeps the table
+    void Clear() noexcept {
+        if (capacity_ == 0) {
+            return;
+        }
+        ForEachSlot([](Slot& slot) { std::destroy_at(&slot); });
+        ResetCtrl();
+        size_ = 0;
+        growth_left_ = MaxLoad(capacity_);
+    }
+
+    bool Find(const Key& key) const {
+        return FindIndex(key, HashOf(key)) != kNotFound;
+    }
+
+    bool Contains(const Key& key) const {
+        return FindIndex(key, HashOf(key)) != kNotFound;
+    }
+
+    ~HashMap() {
+        Clear();
+        Deallocate();
+    }
+
+private:
+    static constexpr size_t kNotFound = static_cast<size_t>(-1);
+
+    // 7/8 of the slots, leaving empty bytes for probes to stop at
+    static size_t MaxLoad(size_t capacity) noexcept {
+        return capacity - capacity / 8;
+    }
+
+    // std::hash of an integer is the integer itself, so spread its bits over the whole word:
+    // H1 (all but the low 7 bits) picks the group, H2 (the low 7 bits) goes to the control byte
+    size_t HashOf(const Key& key) const {
+        uint64_t mixed = static_cast<uint64_t>(hash_(key)) * 0x9E3779B97F4A7C15ULL;
+        return static_cast<size_t>(mixed ^ (mixed >> 32));
+    }
+
+    static Ctrl H2(size_t hash) noexcept {
+        return static_cast<Ctrl>(hash & 0x7F);
+    }
+
+    static size_t H1(size_t hash) noexcept {
+        return hash >> 7;
+    }
+
+    static bool IsFull(Ctrl ctrl) noexcept {
+        return ctrl >= 0;
+    }
+
+    // Without a table, lookups probe this group and find nothing
+    static const Ctrl* EmptyGroup() noexcept {
+        alignas(kGroupWidth) static constexpr Ctrl kEmptyGroup[kGroupWidth] = {
+            kEmpty, kEmpty, kEmpty, kEmpty, kEmpty, kEmpty, kEmpty, kEmpty,
+            kEmpty, kEmpty, kEmpty, kEmpty, kEmpty, kEmpty, kEmpty, kEmpty};
+        return kEmptyGroup;
+    }
+
+    size_t FindIndex(const Key& key, size_t hash) const {
+        Ctrl h2 = H2(hash);
+        size_t pos = H1(hash) & capacity_;
+        for (size_t step = kGroupWidth;; step += kGroupWidth) {
+            Group group(ctrl_ + pos);
+            for (uint32_t match = group.Match(h2); match != 0; match &= match - 1) {
+                size_t index = (pos + std::countr_zero(match)) & capacity_;
+                if (equal_(slots_[index].first, key)) {
+                    return index;
+                }
+            }
+            if (group.MatchEmpty() != 0) {
+                return kNotFound;
+            }
+            pos = (pos + step) & capacity_;
+        }
+    }
+
+    // First empty or deleted slot on the probe sequence of `hash`
+    size_t FindNonFull(size_t hash) const noexcept {
+        size_t pos = H1(hash) & capacity_;
+        for (size_t step = kGroupWidth;; step += kGroupWidth) {
+            if (uint32_t free = Group(ctrl_ + pos).MatchEmptyOrDeleted(); free != 0) {
+                return (pos + std::countr_zero(free)) & capacity_;
+            }
+            pos = (pos + step) & capacity_;
+        }
+    }
+
+    // Slot for a new entry with `hash`, growing the table if it is full
+    size_t PrepareInsert(size_t hash) {
+        size_t index = capacity_ == 0 ? 0 : FindNonFull(hash);
+        // Reusing a deleted slot does not take an empty one away
+        if (growth_left_ == 0 && (capacity_ == 0 || ctrl_[index] != kDeleted)) {
+            if (capacity_ == 0) {
+                Resize(kMinCapacity);
+            } else if (size_ * 2 <= MaxLoad(capacity_)) {
+                // Mostly tombstones: rehash at the same size instead of growing
+                Resize(capacity_);
+            } else {
+                Resize(capacity_ * 2 + 1);
+            }
+            index = FindNonFull(hash);
+        }
+        return index;
+    }
+
+    // Marks the constructed slot `index` as full
+    void Publish(size_t index, size_t hash) noexcept {
+        if (ctrl_[index] == kEmpty) {
+            --growth_left_;
+        }
+        SetCtrl(index, H2(hash));
+        ++size_;
+    }
+
+    // The first kGroupWidth - 1 control bytes are mirrored after the sentinel, so that a group
+    // load at any slot reads the wrapped-around bytes without a bounds check
+    void SetCtrl(size_t index, Ctrl ctrl) noexcept {
+        ctrl_[index] = ctrl;
+        ctrl_[((index - (kGroupWidth - 1)) & capacity_) + (kGroupWidth - 1)] = ctrl;
+    }
+
+    void ResetCtrl() noexcept {
+        std::memset(ctrl_, static_cast<unsigned char>(kEmpty), CtrlBytes(capacity_));
+        ctrl_[capacity_] = kSentinel;
+    }
+
+    static size_t CtrlBytes(size_t capacity) noexcept {
+        return capacity + kGroupWidth;
+    }
+
+    // Control bytes first, then the slots, in one allocation
+    static size_t SlotsOffset(size_t capacity) noexcept {
+        return (CtrlBytes(capacity) + alignof(Slot) - 1) / alignof(Slot) * alignof(Slot);
+    }
+
+    void Resize(size_t capacity) {
+        void* memory = ::operator new(SlotsOffset(capacity) + capacity * sizeof(Slot), std::align_val_t{kAlignment});
+        Ctrl* old_ctrl = ctrl_;
+        Slot* old_slots = slots_;
+        size_t old_capacity = capacity_;
+
+        ctrl_ = static_cast<Ctrl*>(memory);
+        slots_ = reinterpret_cast<Slot*>(static_cast<std::byte*>(memory) + SlotsOffset(capacity));
+        capacity_ = capacity;
+        ResetCtrl();
+        growth_left_ = MaxLoad(capacity) - size_;
+
+        for (size_t i = 0; i < old_capacity; ++i) {
+            if (IsFull(old_ctrl[i])) {
+                size_t hash = HashOf(old_slots[i].first);
+                size_t index = FindNonFull(hash);
+                new (slots_ + index) Slot(std::move(old_slots[i]));
+                std::destroy_at(old_slots + i);
+                SetCtrl(index, H2(hash));
+            }
+        }
+        if (old_capacity != 0) {
+            ::operator delete(old_ctrl, std::align_val_t{kAlignment});
+        }
+    }
+
+    void Deallocate() noexcept {
+        if (capacity_ != 0) {
+            ::operator delete(ctrl_, std::align_val_t{kAlignment});
+        }
+        ctrl_ = const_cast<Ctrl*>(EmptyGroup());
+        slots_ = nullptr;
+        capacity_ = 0;
+        growth_left_ = 0;
+    }
+
+    // Only for a key known to be absent, with room reserved
+    void InsertNew(const Slot& slot) {
+        size_t hash = HashOf(slot.first);
+        size_t index = FindNonFull(hash);
+        new (slots_ + index) Slot(slot);
+        Publish(index, hash);
+    }
+
+    template <typename F>
+    void ForEachSlot(F&& visit) const {
+        for (size_t i = 0; i < capacity_; ++i) {
+            if (IsFull(ctrl_[i])) {
+                visit(slots_[i]);
+            }
+        }
+    }
+
+    // Never written through while capacity_ is 0
+    Ctrl* ctrl_{const_cast<Ctrl*>(EmptyGroup())};
+    Slot* slots_{nullptr};
+    // Number of slots, 2^k - 1 so that it doubles as the probe mask; 0 without a table
+    size_t capacity_{0};
+    size_t size_{0};
+    // Empty slots left to fill before the load limit
+    size_t growth_left_{0};
+    [[no_unique_address]] Hash hash_;
+    [[no_unique_address]] KeyEqual equal_;
+};
+
+namespace std {
+// Global swap overloading
+template <typename Key, typename Value, typename Hash, typename KeyEqual>
+void swap(HashMap<Key, Value, Hash, KeyEqual>& a, HashMap<Key, Value, Hash, KeyEqual>& b) {
+    a.Swap(b);
+}
+}  // namespace std
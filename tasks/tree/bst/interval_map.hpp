@@ -0,0 +1,143 @@
+#pragma once
+
+#include <functional>
+#include <initializer_list>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "augment.hpp"
+#include "balance.hpp"
+#include "map.hpp"
+
+// Closed interval [low, high]
+template <typename Key>
+struct Interval {
+    Key low;
+    Key high;
+
+    bool operator==(const Interval& other) const = default;
+};
+
+// Orders intervals by `low`, then by `high`
+template <typename Key, typename Compare = std::less<Key>>
+struct IntervalLess {
+    bool operator()(const Interval<Key>& a, const Interval<Key>& b) const {
+        if (comp(a.low, b.low)) {
+            return true;
+        }
+        if (comp(b.low, a.low)) {
+            return false;
+        }
+        return comp(a.high, b.high);
+    }
+
+    [[no_unique_address]] Compare comp;
+};
+
+// Dictionary keyed by closed intervals that finds every interval meeting a point or a range.
+//
+// The entries live in a Map ordered by IntervalLess, and each node also keeps the largest `high`
+// of its subtree (MaxEndpoint in augment.hpp). An overlap query walks the tree in key order and
+// skips every subtree that ends before the query starts or starts after it ends, so reporting k
+// entries takes O((k + 1) log n) instead of a scan of all n. Insert and Erase stay O(log n).
+template <typename Key, typename Value, typename Compare = std::less<Key>>
+class IntervalMap {
+private:
+    using Index = Map<Interval<Key>, Value, IntervalLess<Key, Compare>, RedBlackBalance, MaxEndpoint<Key, Compare>>;
+
+public:
+    using Entry = std::pair<const Interval<Key>, Value>;
+
+    IntervalMap() = default;
+
+    IntervalMap(const std::initializer_list<Entry>& values) {
+        Insert(values);
+    }
+
+    // Throws std::runtime_error if `interval` is empty (high < low)
+    Value& operator[](const Interval<Key>& interval) {
+        Check(interval);
+        return index_[interval];
+    }
+
+    inline bool IsEmpty() const noexcept {
+        return index_.IsEmpty();
+    }
+
+    inline size_t Size() const noexcept {
+        return index_.Size();
+    }
+
+    void Swap(IntervalMap& a) {
+        index_.Swap(a.index_);
+    }
+
+    // Copies every entry, ordered by `low`, then by `high`
+    std::vector<Entry> Values(bool is_increase = true) const {
+        return index_.Values(is_increase);
+    }
+
+    // Overwrites the value if the same interval is already present
+    void Insert(const Entry& val) {
+        Check(val.first);
+        index_.Insert(val);
+    }
+
+    void Insert(const std::initializer_list<Entry>& values) {
+        for (const auto& val : values) {
+            Insert(val);
+        }
+    }
+
+    // Throws std::runtime_error if the interval is absent
+    void Erase(const Interval<Key>& interval) {
+        index_.Erase(interval);
+    }
+
+    void Clear() noexcept {
+        index_.Clear();
+    }
+
+    bool Contains(const Interval<Key>& interval) const {
+        return index_.Contains(interval);
+    }
+
+    // Calls `visit` on every entry whose interval meets [low, high], in key order, without
+    // copying the entries
+    template <typename Visit>
+    void ForEachOverlap(const Key& low, const Key& high, Visit&& visit) const {
+        if (!Compare{}(high, low)) {
+            MaxEndpoint<Key, Compare>::Overlaps(index_, low, high, visit);
+        }
+    }
+
+    // Entries whose interval meets [low, high], in key order; none if high < low
+    std::vector<Entry> Overlaps(const Key& low, const Key& high) const {
+        std::vector<Entry> entries;
+        ForEachOverlap(low, high, [&entries](const Entry& entry) { entries.push_back(entry); });
+        return entries;
+    }
+
+    // Entries whose interval contains `point`
+    std::vector<Entry> Stab(const Key& point) const {
+        return Overlaps(point, point);
+    }
+
+private:
+    static void Check(const Interval<Key>& interval) {
+        if (Compare{}(interval.high, interval.low)) {
+            throw std::runtime_error("Interval is empty");
+        }
+    }
+
+    Index index_;
+};
+
+namespace std {
+// Global swap overloading
+template <typename Key, typename Value, typename Compare>
+void swap(IntervalMap<Key, Value, Compare>& a, IntervalMap<Key, Value, Compare>& b) {
+    a.Swap(b);
+}
+}  // namespace std
@@ -2,82 +2,1531 @@
 
 #include <fmt/core.h>
 
+#include <algorithm>
+#include <bit>
 #include <cstdlib>
 #include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
-template <typename Key, typename Value, typename Compare = std::less<Key>>
+#include "augment.hpp"
+#include "balance.hpp"
+#include "node_pool.hpp"
+
+// Ordered dictionary on a binary search tree. `Balance` (see balance.hpp) keeps the height
+// logarithmic, so Insert, Erase, Find and operator[] are O(log n) even for sorted input.
+// SplayBalance instead splays every accessed key to the root: the bounds become amortized, and
+// lookups, const ones included, restructure the tree, so even concurrent reads of such a map race.
+// Nodes come from a NodePool (see node_pool.hpp): the map's own one by default, or a pool shared
+// with other maps of the same type. Maps on their own pools share no mutable state: after a
+// Split each part allocates from its own pool, and the chunks still holding nodes of both parts
+// stay alive until neither needs them.
+//
+// Ascending(), Descending() and Range() are lazy views that walk the tree in place; prefer them
+// to Values(), which copies every entry into a vector.
+//
+// `Augment` (see augment.hpp) keeps extra per-subtree data up to date. With SubtreeSize the map
+// answers order-statistic queries: Select, Rank and CountLess, all O(log n). MaxEndpoint indexes
+// interval keys for IntervalMap (see interval_map.hpp).
+template <typename Key, typename Value, typename Compare = std::less<Key>, typename Balance = RedBlackBalance,
+          typename Augment = NoAugment>
 class Map {
+private:
+    struct Node;
+
+    // Whether lookups may take keys of other types than Key: the comparator declares is_transparent
+    static constexpr bool kTransparent = requires { typename Compare::is_transparent; };
+
+    static constexpr bool kCountsSubtrees = std::is_same_v<Augment, SubtreeSize>;
+
+    // Searches FindMany keeps in flight: about the number of cache misses a core can overlap
+    static constexpr size_t kFindBatch = 16;
+
+    // Walks in key order if `kAscending`, in reverse key order otherwise
+    template <bool kAscending>
+    class BasicIterator {
+    public:
+        // NOLINTNEXTLINE
+        using value_type = std::pair<const Key, Value>;
+        // NOLINTNEXTLINE
+        using reference = value_type&;
+        // NOLINTNEXTLINE
+        using pointer = value_type*;
+        // NOLINTNEXTLINE
+        using difference_type = std::ptrdiff_t;
+        // NOLINTNEXTLINE
+        using iterator_category = std::bidirectional_iterator_tag;
+
+        BasicIterator() = default;
+
+        bool operator==(const BasicIterator& other) const {
+            return current_ == other.current_;
+        }
+
+        bool operator!=(const BasicIterator& other) const {
+            return current_ != other.current_;
+        }
+
+        reference operator*() const {
+            if (current_ == nullptr) {
+                throw std::runtime_error("Dereferencing end iterator");
+            }
+            return current_->value;
+        }
+
+        pointer operator->() const {
+            return &**this;
+        }
+
+        BasicIterator& operator++() {
+            if (current_ != nullptr) {
+                current_ = kAscending ? Next(current_) : Prev(current_);
+            }
+            return *this;
+        }
+
+        BasicIterator operator++(int) {
+            BasicIterator tmp = *this;
+            ++(*this);
+            return tmp;
+        }
+
+        // Stepping back from the end lands on the last entry in iteration order
+        BasicIterator& operator--() {
+            if (current_ == nullptr) {
+                current_ = kAscending ? owner_->rightmost_ : Leftmost(owner_->root_);
+            } else {
+                current_ = kAscending ? Prev(current_) : Next(current_);
+            }
+            return *this;
+        }
+
+        BasicIterator operator--(int) {
+            BasicIterator tmp = *this;
+            --(*this);
+            return tmp;
+        }
+
+    private:
+        BasicIterator(Node* current, const Map* owner) : current_(current), owner_(owner) {
+        }
+
+        Node* current_{nullptr};
+        const Map* owner_{nullptr};
+
+        friend class Map;
+    };
+
 public:
-    Map() {
-        // Not implemented
+    using Pool = NodePool<Node>;
+    using MapIterator = BasicIterator<true>;
+    using ReverseMapIterator = BasicIterator<false>;
+
+    // Half-open sequence of entries; usable in range-for
+    template <typename Iterator>
+    class View {
+    public:
+        // NOLINTNEXTLINE
+        Iterator begin() const noexcept {
+            return first_;
+        }
+
+        // NOLINTNEXTLINE
+        Iterator end() const noexcept {
+            return last_;
+        }
+
+        bool IsEmpty() const noexcept {
+            return first_ == last_;
+        }
+
+    private:
+        View(Iterator first, Iterator last) : first_(first), last_(last) {
+        }
+
+        Iterator first_;
+        Iterator last_;
+
+        friend class Map;
+    };
+
+    Map() = default;
+
+    // Allocates nodes from `pool`, which must outlive the map
+    explicit Map(Pool& pool) : shared_pool_(&pool) {
+    }
+
+    // A copy allocates from the same shared pool as `other`, if it has one
+    Map(const Map& other) : comp(other.comp), shared_pool_(other.shared_pool_) {
+        CopyFrom(other);
+    }
+
+    Map& operator=(const Map& other) {
+        if (this != &other) {
+            Clear();
+            comp = other.comp;
+            CopyFrom(other);
+        }
+        return *this;
     }
 
-    Value& operator[](const Key& /*key*/) {
-        std::abort();  // Not implemented
+    Map(Map&& other) noexcept {
+        Swap(other);
+    }
+
+    Map& operator=(Map&& other) noexcept {
+        if (this != &other) {
+            Clear();
+            Swap(other);
+        }
+        return *this;
+    }
+
+    // Builds a perfectly balanced map in O(n) from entries sorted by key. Of equal keys the last one
+    // wins, as with repeated Insert. Throws std::runtime_error if the input is out of order.
+    template <typename It>
+        requires std::input_iterator<It>
+    static Map BuildFromSorted(It first, It last) {
+        Map map;
+        Node* tail = nullptr;
+        for (; first != last; ++first) {
+            tail = map.AppendSorted(tail, *first);
+        }
+        map.Rebuild();
+        return map;
+    }
+
+    // Sorts a copy of the input (O(n log n)), then builds as BuildFromSorted does
+    template <typename It>
+        requires std::input_iterator<It>
+    static Map BuildFromUnsorted(It first, It last) {
+        std::vector<std::pair<Key, Value>> entries(first, last);
+        Compare comp;
+        // Stable, so that the last of equal keys still wins
+        std::stable_sort(entries.begin(), entries.end(),
+                         [&comp](const auto& lhs, const auto& rhs) { return comp(lhs.first, rhs.first); });
+        return BuildFromSorted(std::make_move_iterator(entries.begin()), std::make_move_iterator(entries.end()));
+    }
+
+    Value& operator[](const Key& key) {
+        return TryEmplace(key).first->second;
     }
 
     inline bool IsEmpty() const noexcept {
-        std::abort();  // Not implemented
+        return size_ == 0;
     }
 
     inline size_t Size() const noexcept {
-        std::abort();  // Not implemented
+        return size_;
     }
 
     void Swap(Map& a) {
         static_assert(std::is_same<decltype(this->comp), decltype(a.comp)>::value,
                       "The compare function types are different");
-        // Not implemented
+        std::swap(root_, a.root_);
+        std::swap(rightmost_, a.rightmost_);
+        std::swap(size_, a.size_);
+        std::swap(comp, a.comp);
+        own_pool_.Swap(a.own_pool_);
+        std::swap(inherited_, a.inherited_);
+        std::swap(shared_pool_, a.shared_pool_);
+    }
+
+    MapIterator Begin() const noexcept {
+        return MapIterator(Leftmost(root_), this);
+    }
+
+    MapIterator End() const noexcept {
+        return MapIterator(nullptr, this);
+    }
+
+    View<MapIterator> Ascending() const noexcept {
+        return {Begin(), End()};
+    }
+
+    View<ReverseMapIterator> Descending() const noexcept {
+        return {ReverseMapIterator(rightmost_, this), ReverseMapIterator(nullptr, this)};
+    }
+
+    // Entries with keys in [from, to), in key order
+    View<MapIterator> Range(const Key& from, const Key& to) const {
+        return RangeOf(from, to);
+    }
+
+    template <typename K>
+        requires kTransparent
+    View<MapIterator> Range(const K& from, const K& to) const {
+        return RangeOf(from, to);
+    }
+
+    // First entry with key not less than `key`, End() if there is none
+    MapIterator LowerBound(const Key& key) const {
+        return MapIterator(LowerBoundNode(key), this);
+    }
+
+    template <typename K>
+        requires kTransparent
+    MapIterator LowerBound(const K& key) const {
+        return MapIterator(LowerBoundNode(key), this);
+    }
+
+    // First entry with key greater than `key`, End() if there is none
+    MapIterator UpperBound(const Key& key) const {
+        return MapIterator(UpperBoundNode(key), this);
+    }
+
+    template <typename K>
+        requires kTransparent
+    MapIterator UpperBound(const K& key) const {
+        return MapIterator(UpperBoundNode(key), this);
+    }
+
+    // {LowerBound(key), UpperBound(key)}: at most one entry, since keys are unique
+    std::pair<MapIterator, MapIterator> EqualRange(const Key& key) const {
+        return EqualRangeOf(key);
+    }
+
+    template <typename K>
+        requires kTransparent
+    std::pair<MapIterator, MapIterator> EqualRange(const K& key) const {
+        return EqualRangeOf(key);
+    }
+
+    // Number of keys in [from, to): O(log n) with SubtreeSize, O(log n + k) otherwise
+    size_t CountRange(const Key& from, const Key& to) const {
+        return CountRangeOf(from, to);
+    }
+
+    template <typename K>
+        requires kTransparent
+    size_t CountRange(const K& from, const K& to) const {
+        return CountRangeOf(from, to);
+    }
+
+    // Entry with the k-th smallest key (from 0), End() if k >= Size()
+    MapIterator Select(size_t k) const
+        requires kCountsSubtrees
+    {
+        Node* node = root_;
+        while (node != nullptr) {
+            size_t left = SubtreeSize::Size(node->left);
+            if (k < left) {
+                node = node->left;
+            } else if (k == left) {
+                break;
+            } else {
+                k -= left + 1;
+                node = node->right;
+            }
+        }
+        return MapIterator(node, this);
+    }
+
+    // Position of `key` in key order (from 0); throws std::runtime_error if it is absent
+    size_t Rank(const Key& key) const
+        requires kCountsSubtrees
+    {
+        if (FindNode(key) == nullptr) {
+            throw std::runtime_error("Value not found");
+        }
+        return CountLessOf(key);
+    }
+
+    // Number of keys less than `key`, which does not have to be present
+    size_t CountLess(const Key& key) const
+        requires kCountsSubtrees
+    {
+        return CountLessOf(key);
+    }
+
+    template <typename K>
+        requires kCountsSubtrees && kTransparent
+    size_t CountLess(const K& key) const {
+        return CountLessOf(key);
+    }
+
+    // Copies every entry; a view does the same walk without the copy
+    std::vector<std::pair<const Key, Value>> Values(bool is_increase = true) const {
+        std::vector<std::pair<const Key, Value>> values;
+        values.reserve(size_);
+        if (is_increase) {
+            for (const auto& entry : Ascending()) {
+                values.push_back(entry);
+            }
+        } else {
+            for (const auto& entry : Descending()) {
+                values.push_back(entry);
+            }
+        }
+        return values;
+    }
+
+    // Overwrites the value if the key is already present
+    void Insert(const std::pair<const Key, Value>& val) {
+        InsertOrAssign(val.first, val.second);
+    }
+
+    // Same as Insert(val), but tries the slot right before `hint` first: appending keys in
+    // increasing order with End() as the hint takes amortized O(1) instead of a descent.
+    // Returns the entry of val.first and whether it was newly inserted.
+    std::pair<MapIterator, bool> Insert(MapIterator hint, const std::pair<const Key, Value>& val) {
+        auto [parent, link] = HintedSlot(hint.current_, val.first);
+        if (*link != nullptr) {
+            (*link)->value.second = val.second;
+            return {MapIterator(*link, this), false};
+        }
+        return {MapIterator(Link(parent, link, NewNode(val)), this), true};
     }
 
-    std::vector<std::pair<const Key, Value>> Values(bool /*is_increase=true*/) const noexcept {
-        std::abort();  // Not implemented
+    // The functions below descend the tree once. They return the entry of the key and whether
+    // it was newly inserted.
+
+    // Constructs the value from `args` in place if `key` is absent; otherwise leaves both untouched
+    template <typename... Args>
+    std::pair<MapIterator, bool> TryEmplace(const Key& key, Args&&... args) {
+        return TryEmplaceImpl(key, std::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    std::pair<MapIterator, bool> TryEmplace(Key&& key, Args&&... args) {
+        return TryEmplaceImpl(std::move(key), std::forward<Args>(args)...);
+    }
+
+    // Inserts, or assigns `value` to the present entry
+    template <typename V>
+    std::pair<MapIterator, bool> InsertOrAssign(const Key& key, V&& value) {
+        return InsertOrAssignImpl(key, std::forward<V>(value));
+    }
+
+    template <typename V>
+    std::pair<MapIterator, bool> InsertOrAssign(Key&& key, V&& value) {
+        return InsertOrAssignImpl(std::move(key), std::forward<V>(value));
     }
 
-    void Insert(const std::pair<const Key, Value>& /*val*/) {
-        // Not implemented
+    // Builds the entry from `args` first, as the standard containers do, then drops it if the key is present
+    template <typename... Args>
+    std::pair<MapIterator, bool> Emplace(Args&&... args) {
+        Node* node = NewNode(std::forward<Args>(args)...);
+        auto [parent, link] = FindSlot(node->value.first);
+        if (Node* found = *link; found != nullptr) {
+            DeleteNode(node);
+            Access(found);
+            return {MapIterator(found, this), false};
+        }
+        return {MapIterator(Link(parent, link, node), this), true};
     }
 
-    void Insert(const std::initializer_list<std::pair<const Key, Value>>& /*values*/) {
-        // Not implemented
+    void Insert(const std::initializer_list<std::pair<const Key, Value>>& values) {
+        for (const auto& val : values) {
+            Insert(val);
+        }
     }
 
-    void Erase(const Key& /*key*/) {
-        // Not implemented
+    void Erase(const Key& key) {
+        EraseNode(FindNode(key));
+    }
+
+    // With a transparent Compare (e.g. std::less<>), takes any key comparable with Key
+    template <typename K>
+        requires kTransparent
+    void Erase(const K& key) {
+        EraseNode(FindNode(key));
     }
 
     void Clear() noexcept {
-        // Not implemented
+        if (shared_pool_ != nullptr) {
+            DestroyTree(root_, true);
+        } else {
+            // Our own pool has none but our nodes: drop its chunks at once instead of node by node,
+            // and let go of the chunks inherited from a Split
+            if constexpr (!std::is_trivially_destructible_v<Node>) {
+                DestroyTree(root_, false);
+            }
+            own_pool_.Release();
+            inherited_.reset();
+        }
+        root_ = nullptr;
+        rightmost_ = nullptr;
+        size_ = 0;
+    }
+
+    bool Find(const Key& key) const {
+        return FindNode(key) != nullptr;
+    }
+
+    template <typename K>
+        requires kTransparent
+    bool Find(const K& key) const {
+        return FindNode(key) != nullptr;
+    }
+
+    bool Contains(const Key& key) const {
+        return FindNode(key) != nullptr;
     }
 
-    bool Find(const Key& /*key*/) const {
-        std::abort();  // Not implemented
+    template <typename K>
+        requires kTransparent
+    bool Contains(const K& key) const {
+        return FindNode(key) != nullptr;
+    }
+
+    // Looks up every key and stores its entry, or End() if it is absent, at the same index of `out`.
+    // Up to kFindBatch searches descend in lockstep, one level per round, each prefetching its next
+    // node, so on a tree larger than the cache their misses overlap instead of queueing up.
+    // On a tree that fits in the cache there are no misses to hide, and a loop of Find is faster.
+    // Throws std::runtime_error if `out` is shorter than `keys`.
+    void FindMany(std::span<const Key> keys, std::span<MapIterator> out) const {
+        if (out.size() < keys.size()) {
+            throw std::runtime_error("Output is shorter than the keys");
+        }
+        if (root_ == nullptr) {
+            std::fill_n(out.begin(), keys.size(), End());
+            return;
+        }
+        struct Search {
+            Node* node;
+            size_t index;
+        };
+        Search searches[kFindBatch];
+        size_t next = 0;
+        size_t active = 0;
+        while (active < kFindBatch && next < keys.size()) {
+            searches[active++] = {root_, next++};
+        }
+        while (active > 0) {
+            for (size_t i = 0; i < active;) {
+                Search& search = searches[i];
+                const Key& key = keys[search.index];
+                Node* node = search.node;
+                Node* found = nullptr;
+                if (comp(key, node->value.first)) {
+                    node = node->left;
+                } else if (comp(node->value.first, key)) {
+                    node = node->right;
+                } else {
+                    found = node;
+                    node = nullptr;
+                }
+                if (node != nullptr) {
+                    __builtin_prefetch(node);
+                    search.node = node;
+                    ++i;
+                    continue;
+                }
+                out[search.index] = MapIterator(found, this);
+                // The finished search makes room for the next key, or for the last one in flight
+                if (next < keys.size()) {
+                    search = {root_, next++};
+                    ++i;
+                } else {
+                    search = searches[--active];
+                }
+            }
+        }
+    }
+
+    // Moves the entries with keys not less than `key` into the returned map in O(log n), without
+    // copying them. Needs SubtreeSize to count the moved entries. On own pools the returned map
+    // allocates from a fresh pool; the chunks of this map's pool, which now hold entries of both,
+    // are handed over to an immutable holder that both maps keep alive.
+    Map Split(const Key& key) {
+        static_assert(kCountsSubtrees, "Split needs SubtreeSize to count the entries it moves");
+        size_t right_size = size_ - CountLessOf(key);
+        size_t left_size = size_ - right_size;
+        Piece left;
+        Piece right;
+        if constexpr (Balance::kSelfAdjusting) {
+            SplitAtRoot(key, left, right);
+        } else if (Node* equal = SplitTree(TakeTree(), key, left, right); equal != nullptr) {
+            right = JoinTrees({}, equal, right);
+        }
+        Map result;
+        result.comp = comp;
+        result.shared_pool_ = shared_pool_;
+        if (shared_pool_ == nullptr) {
+            InheritOwnChunks();
+            result.inherited_ = inherited_;
+        }
+        result.PutTree(right, right_size);
+        PutTree(left, left_size);
+        return result;
+    }
+
+    // Concatenates maps where every key of `left` is less than every key of `right` in O(log n).
+    // Throws std::runtime_error if the key ranges overlap or the maps use different shared pools.
+    static Map Join(Map&& left, Map&& right) {
+        if (right.root_ == nullptr) {
+            return std::move(left);
+        }
+        if (left.root_ == nullptr) {
+            return std::move(right);
+        }
+        Node* mid = Leftmost(right.root_);
+        if (!left.comp(left.rightmost_->value.first, mid->value.first)) {
+            throw std::runtime_error("Key ranges overlap");
+        }
+        left.AdoptNodes(right);
+        right.Detach(mid);
+        size_t size = left.size_ + right.size_ + 1;
+        Piece joined = left.JoinTrees(left.TakeTree(), mid, right.TakeTree());
+        left.PutTree(joined, size);
+        return std::move(left);
+    }
+
+    // The set operations take the nodes of `other` and leave it empty. For sizes m <= n they run in
+    // O(m log(n / m + 1)), which beats m Inserts for maps of similar size: O(n) instead of
+    // O(n log n). A SplayBalance map merges the two key sequences instead, in O(n + m), and ends up
+    // perfectly balanced. They throw std::runtime_error if the maps use different shared pools.
+
+    // Adds every entry of `other`; of equal keys, other's value wins, as with Insert
+    void Union(Map&& other) {
+        if (&other == this) {
+            return;
+        }
+        AdoptNodes(other);
+        if constexpr (Balance::kSelfAdjusting) {
+            MergeChains(other, {.ours_only = true, .theirs_only = true, .common_theirs = true});
+            return;
+        }
+        size_t size = size_ + other.size_;
+        size_t duplicates = 0;
+        Piece tree = UnionTrees(TakeTree(), other.TakeTree(), duplicates);
+        PutTree(tree, size - duplicates);
+    }
+
+    // Keeps only the keys that `other` has too, with the values of this map
+    void Intersection(Map&& other) {
+        if (&other == this) {
+            return;
+        }
+        AdoptNodes(other);
+        if constexpr (Balance::kSelfAdjusting) {
+            MergeChains(other, {.common_ours = true});
+            return;
+        }
+        size_t kept = 0;
+        Piece tree = IntersectTrees(TakeTree(), other.TakeTree(), kept);
+        PutTree(tree, kept);
+    }
+
+    // Removes the keys that `other` has
+    void Difference(Map&& other) {
+        if (&other == this) {
+            Clear();
+            return;
+        }
+        AdoptNodes(other);
+        if constexpr (Balance::kSelfAdjusting) {
+            MergeChains(other, {.ours_only = true});
+            return;
+        }
+        size_t size = size_;
+        size_t removed = 0;
+        Piece tree = SubtractTrees(TakeTree(), other.TakeTree(), removed);
+        PutTree(tree, size - removed);
     }
 
     ~Map() {
-        // Not implemented
+        Clear();
     }
 
 private:
-    class Node {
-        friend class Map;
+    friend Balance;
+    // Lets an augmentation run its own queries over the nodes, as MaxEndpoint does
+    friend Augment;
 
-    private:
-        /*???*/
+    // Plain struct so that the balancing policy can reach the links and its metadata
+    struct Node {
+        std::pair<const Key, Value> value;
+        Node* left{nullptr};
+        Node* right{nullptr};
+        Node* parent{nullptr};
+        [[no_unique_address]] typename Balance::Meta meta{};
+        [[no_unique_address]] typename Augment::Data aug{};
+
+        template <typename... Args>
+        explicit Node(Args&&... args) : value(std::forward<Args>(args)...) {
+        }
     };
-    /*???*/
+
+    template <typename K>
+    Node* FindNode(const K& key) const {
+        Node* node = root_;
+        Node* last = nullptr;
+        while (node != nullptr) {
+            if (comp(key, node->value.first)) {
+                last = node;
+                node = node->left;
+            } else if (comp(node->value.first, key)) {
+                last = node;
+                node = node->right;
+            } else {
+                Access(node);
+                return node;
+            }
+        }
+        // A miss still pays for its descent, so a self-adjusting tree restructures the path too
+        if (last != nullptr) {
+            Access(last);
+        }
+        return nullptr;
+    }
+
+    // Hands a looked-up node to a self-adjusting policy. Lookups are const, but they may rotate
+    // the tree: the rotations touch only the nodes and root_, which is mutable for this.
+    void Access(Node* node) const {
+        if constexpr (Balance::kSelfAdjusting) {
+            Balance::AfterAccess(const_cast<Map&>(*this), node);
+        }
+    }
+
+    void EraseNode(Node* node) {
+        if (node == nullptr) {
+            throw std::runtime_error("Value not found");
+        }
+        Unlink(node);
+    }
+
+    template <typename K, typename... Args>
+    std::pair<MapIterator, bool> TryEmplaceImpl(K&& key, Args&&... args) {
+        auto [parent, link] = FindSlot(key);
+        if (Node* found = *link; found != nullptr) {
+            Access(found);
+            return {MapIterator(found, this), false};
+        }
+        Node* node = NewNode(std::piecewise_construct, std::forward_as_tuple(std::forward<K>(key)),
+                             std::forward_as_tuple(std::forward<Args>(args)...));
+        return {MapIterator(Link(parent, link, node), this), true};
+    }
+
+    template <typename K, typename V>
+    std::pair<MapIterator, bool> InsertOrAssignImpl(K&& key, V&& value) {
+        auto [parent, link] = FindSlot(key);
+        if (Node* found = *link; found != nullptr) {
+            found->value.second = std::forward<V>(value);
+            Access(found);
+            return {MapIterator(found, this), false};
+        }
+        Node* node = NewNode(std::forward<K>(key), std::forward<V>(value));
+        return {MapIterator(Link(parent, link, node), this), true};
+    }
+
+    // Slot for `key` if it belongs right before `hint` (nullptr is the end), a full descent otherwise
+    std::pair<Node*, Node**> HintedSlot(Node* hint, const Key& key) {
+        if (hint == nullptr) {
+            if (rightmost_ == nullptr) {
+                return {nullptr, &root_};
+            }
+            if (comp(rightmost_->value.first, key)) {
+                return {rightmost_, &rightmost_->right};
+            }
+        } else if (comp(key, hint->value.first)) {
+            if (hint->left == nullptr) {
+                Node* prev = Prev(hint);
+                if (prev == nullptr || comp(prev->value.first, key)) {
+                    return {hint, &hint->left};
+                }
+            } else {
+                Node* prev = Rightmost(hint->left);
+                if (comp(prev->value.first, key)) {
+                    return {prev, &prev->right};
+                }
+            }
+        } else if (!comp(hint->value.first, key)) {
+            return {hint->parent, ParentLink(hint)};
+        }
+        return FindSlot(key);
+    }
+
+    // The link that points to `node`
+    Node** ParentLink(Node* node) noexcept {
+        if (node->parent == nullptr) {
+            return &root_;
+        }
+        return node == node->parent->left ? &node->parent->left : &node->parent->right;
+    }
+
+    // Parent of the slot for `key` and the link that points (or would point) to its node
+    std::pair<Node*, Node**> FindSlot(const Key& key) {
+        Node* parent = nullptr;
+        Node** link = &root_;
+        while (*link != nullptr) {
+            if (comp(key, (*link)->value.first)) {
+                parent = *link;
+                link = &parent->left;
+            } else if (comp((*link)->value.first, key)) {
+                parent = *link;
+                link = &parent->right;
+            } else {
+                break;
+            }
+        }
+        return {parent, link};
+    }
+
+    Node* Link(Node* parent, Node** link, Node* node) {
+        node->parent = parent;
+        *link = node;
+        if (parent == nullptr || (parent == rightmost_ && link == &parent->right)) {
+            rightmost_ = node;
+        }
+        ++size_;
+        PullToRoot(node);
+        Balance::AfterInsert(*this, node);
+        return node;
+    }
+
+    void Unlink(Node* z) {
+        Detach(z);
+        DeleteNode(z);
+    }
+
+    // Takes `z` out of the tree without freeing it
+    void Detach(Node* z) {
+        if (z == rightmost_) {
+            rightmost_ = Prev(z);
+        }
+        Node* y = z;
+        Node* x = nullptr;
+        Node* x_parent = nullptr;
+        if (z->left == nullptr) {
+            x = z->right;
+            x_parent = z->parent;
+            Transplant(z, x);
+        } else if (z->right == nullptr) {
+            x = z->left;
+            x_parent = z->parent;
+            Transplant(z, x);
+        } else {
+            // Relink the successor instead of moving values: keys are const
+            y = Leftmost(z->right);
+            x = y->right;
+            if (y->parent == z) {
+                x_parent = y;
+            } else {
+                x_parent = y->parent;
+                Transplant(y, x);
+                y->right = z->right;
+                y->right->parent = y;
+            }
+            Transplant(z, y);
+            y->left = z->left;
+            y->left->parent = y;
+        }
+        // Every node whose subtree lost z lies on the path from x_parent up
+        PullToRoot(x_parent);
+        Balance::AfterErase(*this, z, y, x, x_parent);
+        --size_;
+    }
+
+    // Puts `to` (may be nullptr) where `from` hangs under its parent
+    void Transplant(Node* from, Node* to) noexcept {
+        if (from->parent == nullptr) {
+            root_ = to;
+        } else if (from == from->parent->left) {
+            from->parent->left = to;
+        } else {
+            from->parent->right = to;
+        }
+        if (to != nullptr) {
+            to->parent = from->parent;
+        }
+    }
+
+    // Lifts node->right into the place of `node`
+    void RotateLeft(Node* node) noexcept {
+        Node* top = node->right;
+        node->right = top->left;
+        if (top->left != nullptr) {
+            top->left->parent = node;
+        }
+        Transplant(node, top);
+        top->left = node;
+        node->parent = top;
+        Augment::Pull(node);
+        Augment::Pull(top);
+    }
+
+    // Lifts node->left into the place of `node`
+    void RotateRight(Node* node) noexcept {
+        Node* top = node->left;
+        node->left = top->right;
+        if (top->right != nullptr) {
+            top->right->parent = node;
+        }
+        Transplant(node, top);
+        top->right = node;
+        node->parent = top;
+        Augment::Pull(node);
+        Augment::Pull(top);
+    }
+
+    void PullToRoot(Node* node) noexcept {
+        if constexpr (Augment::kEnabled) {
+            for (; node != nullptr; node = node->parent) {
+                Augment::Pull(node);
+            }
+        }
+    }
+
+    static Node* Leftmost(Node* node) noexcept {
+        while (node != nullptr && node->left != nullptr) {
+            node = node->left;
+        }
+        return node;
+    }
+
+    static Node* Rightmost(Node* node) noexcept {
+        while (node != nullptr && node->right != nullptr) {
+            node = node->right;
+        }
+        return node;
+    }
+
+    // In-order successor through parent links, amortized O(1) over a full walk
+    static Node* Next(Node* node) noexcept {
+        if (node->right != nullptr) {
+            return Leftmost(node->right);
+        }
+        while (node->parent != nullptr && node == node->parent->right) {
+            node = node->parent;
+        }
+        return node->parent;
+    }
+
+    static Node* Prev(Node* node) noexcept {
+        if (node->left != nullptr) {
+            return Rightmost(node->left);
+        }
+        while (node->parent != nullptr && node == node->parent->left) {
+            node = node->parent;
+        }
+        return node->parent;
+    }
+
+    // Links a node for `entry` after `tail` into a chain of right children hanging from root_.
+    // The chain is a valid (if degenerate) tree, so a throwing constructor leaves nothing behind.
+    template <typename Entry>
+    Node* AppendSorted(Node* tail, Entry&& entry) {
+        if (tail != nullptr) {
+            if (comp(entry.first, tail->value.first)) {
+                throw std::runtime_error("Input is not sorted");
+            }
+            if (!comp(tail->value.first, entry.first)) {
+                tail->value.second = std::forward<Entry>(entry).second;
+                return tail;
+            }
+        }
+        Node* node = NewNode(std::forward<Entry>(entry));
+        node->parent = tail;
+        (tail != nullptr ? tail->right : root_) = node;
+        ++size_;
+        return node;
+    }
+
+    // Turns the right-child chain built by AppendSorted into a perfectly balanced tree in O(n)
+    void Rebuild() noexcept {
+        Node* cursor = root_;
+        int full_levels = static_cast<int>(std::bit_width(size_ + 1)) - 1;
+        root_ = BuildBalanced(cursor, size_, 0, full_levels);
+        if (root_ != nullptr) {
+            root_->parent = nullptr;
+        }
+        rightmost_ = Rightmost(root_);
+    }
+
+    // Takes the next `count` nodes of the chain starting at `cursor`, in order
+    Node* BuildBalanced(Node*& cursor, size_t count, int depth, int full_levels) noexcept {
+        if (count == 0) {
+            return nullptr;
+        }
+        Node* left = BuildBalanced(cursor, count / 2, depth + 1, full_levels);
+        Node* node = cursor;
+        cursor = cursor->right;
+        Node* right = BuildBalanced(cursor, count - count / 2 - 1, depth + 1, full_levels);
+        node->left = left;
+        node->right = right;
+        if (left != nullptr) {
+            left->parent = node;
+        }
+        if (right != nullptr) {
+            right->parent = node;
+        }
+        Balance::AfterBuild(node, depth, full_levels);
+        Augment::Pull(node);
+        return node;
+    }
+
+    template <typename K>
+    View<MapIterator> RangeOf(const K& from, const K& to) const {
+        if (!comp(from, to)) {
+            return {End(), End()};
+        }
+        return {MapIterator(LowerBoundNode(from), this), MapIterator(LowerBoundNode(to), this)};
+    }
+
+    template <typename K>
+    std::pair<MapIterator, MapIterator> EqualRangeOf(const K& key) const {
+        Node* lower = LowerBoundNode(key);
+        Node* upper = lower;
+        if (lower != nullptr && !comp(key, lower->value.first)) {
+            upper = Next(lower);
+        }
+        return {MapIterator(lower, this), MapIterator(upper, this)};
+    }
+
+    template <typename K>
+    size_t CountRangeOf(const K& from, const K& to) const {
+        if (!comp(from, to)) {
+            return 0;
+        }
+        if constexpr (kCountsSubtrees) {
+            return CountLessOf(to) - CountLessOf(from);
+        } else {
+            View<MapIterator> view = RangeOf(from, to);
+            size_t count = 0;
+            for (auto it = view.begin(); it != view.end(); ++it) {
+                ++count;
+            }
+            return count;
+        }
+    }
+
+    template <typename K>
+    size_t CountLessOf(const K& key) const {
+        size_t count = 0;
+        Node* node = root_;
+        while (node != nullptr) {
+            if (comp(node->value.first, key)) {
+                count += SubtreeSize::Size(node->left) + 1;
+                node = node->right;
+            } else {
+                node = node->left;
+            }
+        }
+        return count;
+    }
+
+    // First node whose key is not less than `key`, nullptr if there is none
+    template <typename K>
+    Node* LowerBoundNode(const K& key) const {
+        Node* node = root_;
+        Node* bound = nullptr;
+        while (node != nullptr) {
+            if (comp(node->value.first, key)) {
+                node = node->right;
+            } else {
+                bound = node;
+                node = node->left;
+            }
+        }
+        return bound;
+    }
+
+    // First node whose key is greater than `key`, nullptr if there is none
+    template <typename K>
+    Node* UpperBoundNode(const K& key) const {
+        Node* node = root_;
+        Node* bound = nullptr;
+        while (node != nullptr) {
+            if (comp(key, node->value.first)) {
+                bound = node;
+                node = node->left;
+            } else {
+                node = node->right;
+            }
+        }
+        return bound;
+    }
+
+    // Chunks of own pools that Split left holding nodes of several maps. Nobody allocates from
+    // them or writes to them: the maps put the slots they free on their own pools' free lists.
+    // The chunks go back to the system with the last map that inherited them.
+    struct Inherited {
+        Pool chunks;
+        std::shared_ptr<Inherited> older;
+        std::shared_ptr<Inherited> joined;
+
+        Inherited() = default;
+        Inherited(const Inherited&) = delete;
+        Inherited& operator=(const Inherited&) = delete;
+
+        // Splits after inserts chain these up: unlinks the chain in a loop instead of recursing
+        ~Inherited() {
+            std::shared_ptr<Inherited> next = std::move(older);
+            while (next != nullptr && next.use_count() == 1) {
+                next = std::move(next->older);
+            }
+        }
+    };
+
+    // A detached subtree with its rank (see balance.hpp); Split, Join and the set operations work
+    // on these. They use root_ as scratch space for the balancing policy, so the map's own tree must
+    // be taken out first.
+    struct Piece {
+        Node* root{nullptr};
+        int rank{0};
+    };
+
+    Piece TakeTree() noexcept {
+        Piece tree{root_, Balance::Rank(root_)};
+        root_ = nullptr;
+        rightmost_ = nullptr;
+        size_ = 0;
+        return tree;
+    }
+
+    void PutTree(Piece tree, size_t size) noexcept {
+        root_ = tree.root;
+        if (root_ != nullptr) {
+            root_->parent = nullptr;
+        }
+        rightmost_ = Rightmost(root_);
+        size_ = size;
+    }
+
+    Piece DetachChild(Node* node, int rank, Node* child) noexcept {
+        int child_rank = Balance::ChildRank(node, rank, child);
+        if (child == nullptr) {
+            return {};
+        }
+        child->parent = nullptr;
+        return {child, Balance::MakeRoot(child, child_rank)};
+    }
+
+    // Joins `left`, the detached node `mid` and `right`, whose keys go in this order, in
+    // O(|left.rank - right.rank| + 1)
+    Piece JoinTrees(Piece left, Node* mid, Piece right) {
+        Node* parent = nullptr;
+        if (left.rank >= right.rank) {
+            // Down the right spine of the higher tree to a subtree as high as the lower one
+            Node* node = left.root;
+            int rank = left.rank;
+            while (!Balance::JoinsAt(node, rank, right.rank)) {
+                rank = Balance::ChildRank(node, rank, node->right);
+                parent = node;
+                node = node->right;
+            }
+            Hang(mid, node, right.root);
+            root_ = parent != nullptr ? left.root : mid;
+            if (parent != nullptr) {
+                parent->right = mid;
+            }
+        } else {
+            Node* node = right.root;
+            int rank = right.rank;
+            while (!Balance::JoinsAt(node, rank, left.rank)) {
+                rank = Balance::ChildRank(node, rank, node->left);
+                parent = node;
+                node = node->left;
+            }
+            Hang(mid, left.root, node);
+            root_ = parent != nullptr ? right.root : mid;
+            if (parent != nullptr) {
+                parent->left = mid;
+            }
+        }
+        mid->parent = parent;
+        Augment::Pull(mid);
+        PullToRoot(parent);
+        int rank = Balance::AfterJoin(*this, mid, std::max(left.rank, right.rank));
+        Piece joined{root_, rank};
+        root_ = nullptr;
+        return joined;
+    }
+
+    static void Hang(Node* node, Node* left, Node* right) noexcept {
+        node->left = left;
+        node->right = right;
+        if (left != nullptr) {
+            left->parent = node;
+        }
+        if (right != nullptr) {
+            right->parent = node;
+        }
+    }
+
+    // Joins trees whose keys go in this order, using the last node of `left` as the middle one
+    Piece Join2(Piece left, Piece right) {
+        if (left.root == nullptr) {
+            return right;
+        }
+        if (right.root == nullptr) {
+            return left;
+        }
+        Piece rest;
+        Node* last = SplitLast(left, rest);
+        return JoinTrees(rest, last, right);
+    }
+
+    // Takes the last node out of `tree` into the return value, the other nodes into `rest`
+    Node* SplitLast(Piece tree, Piece& rest) {
+        Node* node = tree.root;
+        Piece left = DetachChild(node, tree.rank, node->left);
+        if (node->right == nullptr) {
+            rest = left;
+            return node;
+        }
+        Piece right_rest;
+        Node* last = SplitLast(DetachChild(node, tree.rank, node->right), right_rest);
+        rest = JoinTrees(left, node, right_rest);
+        return last;
+    }
+
+    // Splits `tree` into the keys less than `key` and the keys greater than it. Returns the node
+    // with `key` itself, detached, or nullptr. O(log n): the joins on the way up telescope.
+    template <typename K>
+    Node* SplitTree(Piece tree, const K& key, Piece& left, Piece& right) {
+        Node* node = tree.root;
+        if (node == nullptr) {
+            left = {};
+            right = {};
+            return nullptr;
+        }
+        Piece node_left = DetachChild(node, tree.rank, node->left);
+        Piece node_right = DetachChild(node, tree.rank, node->right);
+        if (comp(key, node->value.first)) {
+            Piece right_part;
+            Node* equal = SplitTree(node_left, key, left, right_part);
+            right = JoinTrees(right_part, node, node_right);
+            return equal;
+        }
+        if (comp(node->value.first, key)) {
+            Piece left_part;
+            Node* equal = SplitTree(node_right, key, left_part, right);
+            left = JoinTrees(node_left, node, left_part);
+            return equal;
+        }
+        left = node_left;
+        right = node_right;
+        return node;
+    }
+
+    // A self-adjusting tree has no bound on the path SplitTree recurses down. Instead it raises
+    // the last node on the search path for `key` to the root and cuts the tree next to it.
+    void SplitAtRoot(const Key& key, Piece& left, Piece& right) {
+        Node* near = nullptr;
+        for (Node* node = root_; node != nullptr;) {
+            near = node;
+            if (comp(key, node->value.first)) {
+                node = node->left;
+            } else if (comp(node->value.first, key)) {
+                node = node->right;
+            } else {
+                break;
+            }
+        }
+        if (near == nullptr) {
+            left = {};
+            right = {};
+            return;
+        }
+        Balance::Raise(*this, near);
+        TakeTree();
+        bool near_goes_right = !comp(near->value.first, key);
+        Node*& link = near_goes_right ? near->left : near->right;
+        Node* cut = link;
+        link = nullptr;
+        if (cut != nullptr) {
+            cut->parent = nullptr;
+        }
+        Augment::Pull(near);
+        Piece rest{cut, Balance::Rank(cut)};
+        Piece with_near{near, Balance::Rank(near)};
+        left = near_goes_right ? rest : with_near;
+        right = near_goes_right ? with_near : rest;
+    }
+
+    // The set operations split `b` by the root of `a` and recurse into both halves
+
+    Piece UnionTrees(Piece a, Piece b, size_t& duplicates) {
+        if (a.root == nullptr) {
+            return b;
+        }
+        if (b.root == nullptr) {
+            return a;
+        }
+        Node* pivot = a.root;
+        Piece a_left = DetachChild(pivot, a.rank, pivot->left);
+        Piece a_right = DetachChild(pivot, a.rank, pivot->right);
+        Piece b_left;
+        Piece b_right;
+        if (Node* equal = SplitTree(b, pivot->value.first, b_left, b_right); equal != nullptr) {
+            // Keep the node of `b`, it holds the value that wins
+            DeleteNode(pivot);
+            pivot = equal;
+            ++duplicates;
+        }
+        Piece left = UnionTrees(a_left, b_left, duplicates);
+        Piece right = UnionTrees(a_right, b_right, duplicates);
+        return JoinTrees(left, pivot, right);
+    }
+
+    Piece IntersectTrees(Piece a, Piece b, size_t& kept) {
+        if (a.root == nullptr || b.root == nullptr) {
+            DestroyTree(a.root, true);
+            DestroyTree(b.root, true);
+            return {};
+        }
+        Node* pivot = a.root;
+        Piece a_left = DetachChild(pivot, a.rank, pivot->left);
+        Piece a_right = DetachChild(pivot, a.rank, pivot->right);
+        Piece b_left;
+        Piece b_right;
+        Node* equal = SplitTree(b, pivot->value.first, b_left, b_right);
+        Piece left = IntersectTrees(a_left, b_left, kept);
+        Piece right = IntersectTrees(a_right, b_right, kept);
+        if (equal == nullptr) {
+            DeleteNode(pivot);
+            return Join2(left, right);
+        }
+        DeleteNode(equal);
+        ++kept;
+        return JoinTrees(left, pivot, right);
+    }
+
+    Piece SubtractTrees(Piece a, Piece b, size_t& removed) {
+        if (a.root == nullptr || b.root == nullptr) {
+            DestroyTree(b.root, true);
+            return a;
+        }
+        Node* pivot = a.root;
+        Piece a_left = DetachChild(pivot, a.rank, pivot->left);
+        Piece a_right = DetachChild(pivot, a.rank, pivot->right);
+        Piece b_left;
+        Piece b_right;
+        Node* equal = SplitTree(b, pivot->value.first, b_left, b_right);
+        Piece left = SubtractTrees(a_left, b_left, removed);
+        Piece right = SubtractTrees(a_right, b_right, removed);
+        if (equal == nullptr) {
+            return JoinTrees(left, pivot, right);
+        }
+        DeleteNode(equal);
+        DeleteNode(pivot);
+        ++removed;
+        return Join2(left, right);
+    }
+
+    // A splay tree does not bound the paths the recursive set operations above go down, so its
+    // set operations merge the trees as chains in key order instead. The rule names the nodes
+    // that stay: those whose key only one map has, and of two nodes with one key.
+    struct MergeRule {
+        bool ours_only{false};
+        bool theirs_only{false};
+        bool common_ours{false};
+        bool common_theirs{false};
+    };
+
+    void MergeChains(Map& other, MergeRule rule) {
+        Flatten();
+        other.Flatten();
+        Node* head = nullptr;
+        Node* tail = nullptr;
+        size_t size = 0;
+        auto take = [&](Node* node, bool keep) {
+            if (!keep) {
+                DeleteNode(node);
+                return;
+            }
+            node->parent = tail;
+            (tail != nullptr ? tail->right : head) = node;
+            tail = node;
+            ++size;
+        };
+        while (root_ != nullptr || other.root_ != nullptr) {
+            if (other.root_ == nullptr ||
+                (root_ != nullptr && comp(root_->value.first, other.root_->value.first))) {
+                take(PopFront(), rule.ours_only);
+            } else if (root_ == nullptr || comp(other.root_->value.first, root_->value.first)) {
+                take(other.PopFront(), rule.theirs_only);
+            } else {
+                take(PopFront(), rule.common_ours);
+                take(other.PopFront(), rule.common_theirs);
+            }
+        }
+        root_ = head;
+        size_ = size;
+        Rebuild();
+    }
+
+    // Rearranges the tree into a chain of right children in key order, rotating left children up
+    // as DestroyTree does. Augmented data is left stale: the chain only feeds MergeChains.
+    void Flatten() noexcept {
+        Node* head = nullptr;
+        Node* tail = nullptr;
+        Node* cur = root_;
+        while (cur != nullptr) {
+            if (cur->left != nullptr) {
+                Node* left = cur->left;
+                cur->left = left->right;
+                left->right = cur;
+                cur = left;
+            } else {
+                cur->parent = tail;
+                (tail != nullptr ? tail->right : head) = cur;
+                tail = cur;
+                cur = cur->right;
+            }
+        }
+        root_ = head;
+    }
+
+    // Takes the first node off the chain left by Flatten
+    Node* PopFront() noexcept {
+        Node* node = root_;
+        root_ = node->right;
+        if (root_ != nullptr) {
+            root_->parent = nullptr;
+        } else {
+            rightmost_ = nullptr;
+        }
+        --size_;
+        node->right = nullptr;
+        return node;
+    }
+
+    // Lets this map take over the nodes of `other`: both must draw from one shared pool, or each
+    // from its own one, whose chunks then move here along with the chunks it inherited
+    void AdoptNodes(Map& other) {
+        if (shared_pool_ != other.shared_pool_) {
+            throw std::runtime_error("Maps use different node pools");
+        }
+        if (shared_pool_ != nullptr) {
+            return;
+        }
+        own_pool_.Adopt(other.own_pool_);
+        if (inherited_ == nullptr || inherited_ == other.inherited_) {
+            inherited_ = other.inherited_;
+        } else if (other.inherited_ != nullptr) {
+            auto both = std::make_shared<Inherited>();
+            both->older = std::move(inherited_);
+            both->joined = other.inherited_;
+            inherited_ = std::move(both);
+        }
+    }
+
+    // Hands the chunks of our own pool to a new Inherited shared with a map split off. The pool
+    // keeps its free slots and the rest of its last chunk, which the holder keeps alive for us.
+    void InheritOwnChunks() {
+        if (!own_pool_.HasChunks()) {
+            return;
+        }
+        auto holder = std::make_shared<Inherited>();
+        holder->chunks.TakeChunks(own_pool_);
+        holder->older = std::move(inherited_);
+        inherited_ = std::move(holder);
+    }
+
+    void CopyFrom(const Map& other) {
+        CopyTree(other.root_);
+        size_ = other.size_;
+    }
+
+    // Clones the shape and balancing metadata of the tree at `src_root` (into an empty map) without
+    // recursion. Leaves the size to the caller.
+    void CopyTree(const Node* src_root) {
+        if (src_root == nullptr) {
+            return;
+        }
+        root_ = Clone(src_root, nullptr);
+        const Node* src = src_root;
+        Node* dst = root_;
+        try {
+            while (src != nullptr) {
+                if (src->left != nullptr && dst->left == nullptr) {
+                    dst->left = Clone(src->left, dst);
+                    src = src->left;
+                    dst = dst->left;
+                } else if (src->right != nullptr && dst->right == nullptr) {
+                    dst->right = Clone(src->right, dst);
+                    src = src->right;
+                    dst = dst->right;
+                } else {
+                    src = src->parent;
+                    dst = dst->parent;
+                }
+            }
+        } catch (...) {
+            Clear();
+            throw;
+        }
+        rightmost_ = Rightmost(root_);
+    }
+
+    Node* Clone(const Node* src, Node* parent) {
+        Node* node = NewNode(src->value);
+        node->meta = src->meta;
+        node->aug = src->aug;
+        node->parent = parent;
+        return node;
+    }
+
+    Pool& NodeSource() noexcept {
+        return shared_pool_ != nullptr ? *shared_pool_ : own_pool_;
+    }
+
+    template <typename... Args>
+    Node* NewNode(Args&&... args) {
+        void* memory = NodeSource().Allocate();
+        try {
+            return new (memory) Node(std::forward<Args>(args)...);
+        } catch (...) {
+            NodeSource().Deallocate(memory);
+            throw;
+        }
+    }
+
+    void DeleteNode(Node* node) noexcept {
+        node->~Node();
+        NodeSource().Deallocate(node);
+    }
+
+    // Destroys every node of the tree at `root`, handing the slots back to the pool if `deallocate`
+    // is set. Rotates left children up while going, so no recursion or stack even on deep trees.
+    void DestroyTree(Node* root, bool deallocate) noexcept {
+        Node* cur = root;
+        while (cur != nullptr) {
+            if (cur->left != nullptr) {
+                Node* left = cur->left;
+                cur->left = left->right;
+                left->right = cur;
+                cur = left;
+            } else {
+                Node* right = cur->right;
+                if (deallocate) {
+                    DeleteNode(cur);
+                } else {
+                    cur->~Node();
+                }
+                cur = right;
+            }
+        }
+    }
 
 private:
     Compare comp;
-    /*???*/
+    // Mutable for self-adjusting lookups, see Access
+    mutable Node* root_{nullptr};
+    Node* rightmost_{nullptr};
+    size_t size_{0};
+    Pool own_pool_;
+    // Chunks of own pools that Split left shared with other maps, see Inherited
+    std::shared_ptr<Inherited> inherited_;
+    Pool* shared_pool_{nullptr};
 };
 
 namespace std {
 // Global swap overloading
-template <typename Key, typename Value>
-void swap(Map<Key, Value>& a, Map<Key, Value>& b) {
+template <typename Key, typename Value, typename Compare, typename Balance, typename Augment>
+void swap(Map<Key, Value, Compare, Balance, Augment>& a, Map<Key, Value, Compare, Balance, Augment>& b) {
     a.Swap(b);
 }
-}  // namespace std
\ No newline at end of file
+}  // namespace std
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <new>
+#include <utility>
+
+// Slab allocator for objects of one type. Slots are carved out of chunks that double in size
+// up to kMaxChunkSlots; freed slots go to an intrusive free list and are handed out first.
+// Chunks go back to the system only on Release() or destruction, all at once.
+//
+// Not thread-safe: a pool shared by several maps must be used from one thread at a time,
+// and must outlive every map that allocates from it.
+template <typename T>
+class NodePool {
+public:
+    NodePool() = default;
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
+
+    ~NodePool() {
+        Release();
+    }
+
+    void* Allocate() {
+        if (free_ != nullptr) {
+            FreeSlot* slot = free_;
+            free_ = slot->next;
+            return slot;
+        }
+        if (bump_left_ == 0) {
+            NewChunk();
+        }
+        void* slot = bump_;
+        bump_ += kSlotBytes;
+        --bump_left_;
+        return slot;
+    }
+
+    void Deallocate(void* ptr) noexcept {
+        auto* slot = static_cast<FreeSlot*>(ptr);
+        if (free_ == nullptr) {
+            free_tail_ = slot;
+        }
+        slot->next = free_;
+        free_ = slot;
+    }
+
+    // Frees every chunk: O(number of chunks), no matter how many slots are in use
+    void Release() noexcept {
+        while (chunks_ != nullptr) {
+            Chunk* next = chunks_->next;
+            ::operator delete(chunks_, std::align_val_t{kAlignment});
+            chunks_ = next;
+        }
+        Forget();
+    }
+
+    // Takes over the chunks and free slots of `other` in O(1), leaving it empty: objects allocated
+    // from `other` may then be deallocated here. Of the two partly used chunks, the emptier one
+    // keeps handing out slots; the rest of the other one waits for Release.
+    void Adopt(NodePool& other) noexcept {
+        if (other.chunks_ == nullptr) {
+            return;
+        }
+        if (chunks_ == nullptr) {
+            chunks_tail_ = other.chunks_tail_;
+        }
+        other.chunks_tail_->next = chunks_;
+        chunks_ = other.chunks_;
+        if (other.free_ != nullptr) {
+            if (free_ == nullptr) {
+                free_tail_ = other.free_tail_;
+            }
+            other.free_tail_->next = free_;
+            free_ = other.free_;
+        }
+        if (other.bump_left_ > bump_left_) {
+            bump_ = other.bump_;
+            bump_left_ = other.bump_left_;
+        }
+        next_chunk_slots_ = std::max(next_chunk_slots_, other.next_chunk_slots_);
+        other.Forget();
+    }
+
+    bool HasChunks() const noexcept {
+        return chunks_ != nullptr;
+    }
+
+    // Takes over the chunks of `other` in O(1) but leaves it its free slots and the rest of its
+    // last chunk: `other` may keep handing those out for as long as this pool lives
+    void TakeChunks(NodePool& other) noexcept {
+        if (other.chunks_ == nullptr) {
+            return;
+        }
+        if (chunks_ == nullptr) {
+            chunks_tail_ = other.chunks_tail_;
+        }
+        other.chunks_tail_->next = chunks_;
+        chunks_ = other.chunks_;
+        other.chunks_ = nullptr;
+        other.chunks_tail_ = nullptr;
+    }
+
+    void Swap(NodePool& other) noexcept {
+        std::swap(chunks_, other.chunks_);
+        std::swap(chunks_tail_, other.chunks_tail_);
+        std::swap(free_, other.free_);
+        std::swap(free_tail_, other.free_tail_);
+        std::swap(bump_, other.bump_);
+        std::swap(bump_left_, other.bump_left_);
+        std::swap(next_chunk_slots_, other.next_chunk_slots_);
+    }
+
+private:
+    struct Chunk {
+        Chunk* next;
+    };
+
+    struct FreeSlot {
+        FreeSlot* next;
+    };
+
+    static constexpr size_t kMinChunkSlots = 16;
+    static constexpr size_t kMaxChunkSlots = 4096;
+    static constexpr size_t kSlotAlign = std::max(alignof(T), alignof(FreeSlot));
+    static constexpr size_t kSlotBytes = (std::max(sizeof(T), sizeof(FreeSlot)) + kSlotAlign - 1) / kSlotAlign * kSlotAlign;
+    static constexpr size_t kAlignment = std::max(kSlotAlign, alignof(Chunk));
+    static constexpr size_t kHeaderBytes = (sizeof(Chunk) + kSlotAlign - 1) / kSlotAlign * kSlotAlign;
+
+    // Drops every chunk without freeing it
+    void Forget() noexcept {
+        chunks_ = nullptr;
+        chunks_tail_ = nullptr;
+        free_ = nullptr;
+        free_tail_ = nullptr;
+        bump_ = nullptr;
+        bump_left_ = 0;
+        next_chunk_slots_ = kMinChunkSlots;
+    }
+
+    void NewChunk() {
+        void* memory = ::operator new(kHeaderBytes + next_chunk_slots_ * kSlotBytes, std::align_val_t{kAlignment});
+        auto* chunk = static_cast<Chunk*>(memory);
+        chunk->next = chunks_;
+        if (chunks_ == nullptr) {
+            chunks_tail_ = chunk;
+        }
+        chunks_ = chunk;
+        bump_ = static_cast<std::byte*>(memory) + kHeaderBytes;
+        bump_left_ = next_chunk_slots_;
+        next_chunk_slots_ = std::min(next_chunk_slots_ * 2, kMaxChunkSlots);
+    }
+
+    Chunk* chunks_{nullptr};
+    Chunk* chunks_tail_{nullptr};
+    FreeSlot* free_{nullptr};
+    // Valid only while free_ is not nullptr
+    FreeSlot* free_tail_{nullptr};
+    std::byte* bump_{nullptr};
+    size_t bump_left_{0};
+    size_t next_chunk_slots_{kMinChunkSlots};
+};
@@ -0,0 +1,321 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// Ordered dictionary whose versions share structure: a persistent AVL tree with path copying.
+// Snapshot() is O(1) and returns an independent map; later updates to either side copy only the
+// O(log n) nodes on the path they touch and leave the other version as it was.
+//
+// Nodes are reference counted: a node is freed when the last version that reaches it is updated
+// away or destroyed. A node referenced by a single version is updated in place, so a map without
+// live snapshots allocates no more than a plain tree.
+//
+// The counters are atomic, so a snapshot may be read on another thread while the map it was taken
+// from keeps changing. A single PersistentMap object is not thread-safe.
+template <typename Key, typename Value, typename Compare = std::less<Key>>
+class PersistentMap {
+private:
+    struct Node {
+        std::pair<const Key, Value> data;
+        Node* left{nullptr};
+        Node* right{nullptr};
+        int height{1};
+        // Number of parents and versions (as root) that reference the node
+        std::atomic<size_t> refs{1};
+
+        explicit Node(const std::pair<const Key, Value>& val) : data(val) {
+        }
+
+        // Shares the children of `other`
+        explicit Node(const Node& other)
+            : data(other.data), left(Acquire(other.left)), right(Acquire(other.right)), height(other.height) {
+        }
+    };
+
+public:
+    PersistentMap() = default;
+
+    // O(1): shares every node with `other`
+    PersistentMap(const PersistentMap& other)
+        : root_(Acquire(other.root_)), size_(other.size_), comp_(other.comp_) {
+    }
+
+    PersistentMap& operator=(const PersistentMap& other) {
+        if (this != &other) {
+            PersistentMap copy(other);
+            Swap(copy);
+        }
+        return *this;
+    }
+
+    PersistentMap(PersistentMap&& other) noexcept {
+        Swap(other);
+    }
+
+    PersistentMap& operator=(PersistentMap&& other) noexcept {
+        if (this != &other) {
+            Clear();
+            Swap(other);
+        }
+        return *this;
+    }
+
+    // Point-in-time copy of the map in O(1). It stays unchanged whatever happens to this map later.
+    PersistentMap Snapshot() const {
+        return *this;
+    }
+
+    // Copies the path to the entry if it is shared with a snapshot. The reference is valid until
+    // the next update of this map.
+    Value& operator[](const Key& key) {
+        Value* value = nullptr;
+        root_ = Access(root_, key, value);
+        return *value;
+    }
+
+    inline bool IsEmpty() const noexcept {
+        return size_ == 0;
+    }
+
+    inline size_t Size() const noexcept {
+        return size_;
+    }
+
+    void Swap(PersistentMap& a) noexcept {
+        std::swap(root_, a.root_);
+        std::swap(size_, a.size_);
+        std::swap(comp_, a.comp_);
+    }
+
+    std::vector<std::pair<const Key, Value>> Values(bool is_increase = true) const {
+        std::vector<std::pair<const Key, Value>> values;
+        values.reserve(size_);
+        Collect(root_, is_increase, values);
+        return values;
+    }
+
+    // Overwrites the value if the key is already present
+    void Insert(const std::pair<const Key, Value>& val) {
+        root_ = InsertAt(root_, val);
+    }
+
+    void Insert(const std::initializer_list<std::pair<const Key, Value>>& values) {
+        for (const auto& val : values) {
+            Insert(val);
+        }
+    }
+
+    void Erase(const Key& key) {
+        // Checked up front: the recursive removal hands subtrees over on the way down
+        if (!Find(key)) {
+            throw std::runtime_error("Value not found");
+        }
+        root_ = EraseAt(root_, key);
+    }
+
+    // Frees only the nodes no snapshot shares
+    void Clear() noexcept {
+        Release(root_);
+        root_ = nullptr;
+        size_ = 0;
+    }
+
+    bool Find(const Key& key) const {
+        const Node* node = root_;
+        while (node != nullptr) {
+            if (comp_(key, node->data.first)) {
+                node = node->left;
+            } else if (comp_(node->data.first, key)) {
+                node = node->right;
+            } else {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    ~PersistentMap() {
+        Clear();
+    }
+
+private:
+    static Node* Acquire(Node* node) noexcept {
+        if (node != nullptr) {
+            node->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+        return node;
+    }
+
+    // Drops one reference; recursion depth is bounded by the tree height
+    static void Release(Node* node) noexcept {
+        if (node != nullptr && node->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            Release(node->left);
+            Release(node->right);
+            delete node;
+        }
+    }
+
+    // Turns our reference to `node` into a node only we reference: the node itself if no one
+    // else does, a copy sharing its children otherwise
+    static Node* Own(Node* node) {
+        if (node->refs.load(std::memory_order_acquire) == 1) {
+            return node;
+        }
+        Node* copy = new Node(*node);
+        Release(node);
+        return copy;
+    }
+
+    static int Height(const Node* node) noexcept {
+        return node != nullptr ? node->height : 0;
+    }
+
+    static void Update(Node* node) noexcept {
+        node->height = 1 + std::max(Height(node->left), Height(node->right));
+    }
+
+    // The rotations take an owned node and own the child they lift
+    static Node* RotateLeft(Node* node) {
+        Node* right = Own(node->right);
+        node->right = right->left;
+        right->left = node;
+        Update(node);
+        Update(right);
+        return right;
+    }
+
+    static Node* RotateRight(Node* node) {
+        Node* left = Own(node->left);
+        node->left = left->right;
+        left->right = node;
+        Update(node);
+        Update(left);
+        return left;
+    }
+
+    static Node* Rebalance(Node* node) {
+        Update(node);
+        int balance = Height(node->left) - Height(node->right);
+        if (balance > 1) {
+            if (Height(node->left->left) < Height(node->left->right)) {
+                node->left = RotateLeft(Own(node->left));
+            }
+            return RotateRight(node);
+        }
+        if (balance < -1) {
+            if (Height(node->right->right) < Height(node->right->left)) {
+                node->right = RotateRight(Own(node->right));
+            }
+            return RotateLeft(node);
+        }
+        return node;
+    }
+
+    // The recursive updates below take over our reference to `node` and return the reference to
+    // the updated subtree
+
+    Node* InsertAt(Node* node, const std::pair<const Key, Value>& val) {
+        if (node == nullptr) {
+            auto* leaf = new Node(val);
+            ++size_;
+            return leaf;
+        }
+        node = Own(node);
+        if (comp_(val.first, node->data.first)) {
+            node->left = InsertAt(node->left, val);
+        } else if (comp_(node->data.first, val.first)) {
+            node->right = InsertAt(node->right, val);
+        } else {
+            node->data.second = val.second;
+            return node;
+        }
+        return Rebalance(node);
+    }
+
+    Node* Access(Node* node, const Key& key, Value*& value) {
+        if (node == nullptr) {
+            node = new Node(std::pair<const Key, Value>(key, Value()));
+            ++size_;
+            value = &node->data.second;
+            return node;
+        }
+        node = Own(node);
+        if (comp_(key, node->data.first)) {
+            node->left = Access(node->left, key, value);
+        } else if (comp_(node->data.first, key)) {
+            node->right = Access(node->right, key, value);
+        } else {
+            value = &node->data.second;
+            return node;
+        }
+        return Rebalance(node);
+    }
+
+    // `key` must be present
+    Node* EraseAt(Node* node, const Key& key) {
+        if (comp_(key, node->data.first)) {
+            node = Own(node);
+            node->left = EraseAt(node->left, key);
+            return Rebalance(node);
+        }
+        if (comp_(node->data.first, key)) {
+            node = Own(node);
+            node->right = EraseAt(node->right, key);
+            return Rebalance(node);
+        }
+        --size_;
+        // Keep the children, drop the node: a snapshot may still hold it
+        Node* left = Acquire(node->left);
+        Node* right = Acquire(node->right);
+        Release(node);
+        if (right == nullptr) {
+            return left;
+        }
+        Node* min = nullptr;
+        right = DetachMin(right, min);
+        min->left = left;
+        min->right = right;
+        return Rebalance(min);
+    }
+
+    // Unlinks the leftmost node of the subtree into `min`, owned and without children
+    static Node* DetachMin(Node* node, Node*& min) {
+        node = Own(node);
+        if (node->left == nullptr) {
+            Node* right = node->right;
+            node->right = nullptr;
+            min = node;
+            return right;
+        }
+        node->left = DetachMin(node->left, min);
+        return Rebalance(node);
+    }
+
+    static void Collect(const Node* node, bool is_increase, std::vector<std::pair<const Key, Value>>& values) {
+        if (node == nullptr) {
+            return;
+        }
+        Collect(is_increase ? node->left : node->right, is_increase, values);
+        values.push_back(node->data);
+        Collect(is_increase ? node->right : node->left, is_increase, values);
+    }
+
+    Node* root_{nullptr};
+    size_t size_{0};
+    Compare comp_;
+};
+
+namespace std {
+// Global swap overloading
+template <typename Key, typename Value, typename Compare>
+void swap(PersistentMap<Key, Value, Compare>& a, PersistentMap<Key, Value, Compare>& b) {
+    a.Swap(b);
+}
+}  // namespace std
@@ -1,13 +1,28 @@
-#include <random>
+#include <algorithm>
+#include <cmath>
 #include <map>
+#include <mutex>
+#include <random>
+#include <shared_mutex>
+#include <span>
 #include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
 
 #include <benchmark/benchmark.h>
 #include <fmt/core.h>
 
+#include "../btree_map.hpp"
+#include "../concurrent_map.hpp"
+#include "../frozen_map.hpp"
+#include "../hash_map.hpp"
+#include "../interval_map.hpp"
 #include "../map.hpp"
+#include "../persistent_map.hpp"
 
-void ConstructRandomMap(Map<int, int>& mp, int sz) {
+template <typename Balance, typename Augment>
+void ConstructRandomMap(Map<int, int, std::less<int>, Balance, Augment>& mp, int sz) {
   std::random_device rd;
   std::mt19937 mt(rd());
   std::uniform_int_distribution<int> dist(INT_MIN, INT_MAX);
@@ -31,13 +46,51 @@ void ConstructRandomMap(std::map<int, int>& mp, int sz) {
   }
 }
 
-void ConstructLinearMap(Map<int, int>& mp, int sz) {
+template <typename Balance, typename Augment>
+void ConstructLinearMap(Map<int, int, std::less<int>, Balance, Augment>& mp, int sz) {
+  while(sz) {
+    mp.Insert(std::pair{sz, 1});
+    --sz;
+  }
+}
+
+void ConstructRandomMap(BTreeMap<int, int>& mp, int sz) {
+  std::random_device rd;
+  std::mt19937 mt(rd());
+  std::uniform_int_distribution<int> dist(INT_MIN, INT_MAX);
+  while(sz) {
+    mp.Insert(std::pair{dist(mt), 1});
+    --sz;
+  }
+}
+
+void ConstructLinearMap(BTreeMap<int, int>& mp, int sz) {
   while(sz) {
     mp.Insert(std::pair{sz, 1});
     --sz;
   }
 }
 
+void ConstructRandomMap(HashMap<int, int>& mp, int sz) {
+  std::random_device rd;
+  std::mt19937 mt(rd());
+  std::uniform_int_distribution<int> dist(INT_MIN, INT_MAX);
+  while(sz) {
+    mp.Insert(std::pair{dist(mt), 1});
+    --sz;
+  }
+}
+
+void ConstructRandomMap(std::unordered_map<int, int>& mp, int sz) {
+  std::random_device rd;
+  std::mt19937 mt(rd());
+  std::uniform_int_distribution<int> dist(INT_MIN, INT_MAX);
+  while(sz) {
+    mp.insert(std::pair{dist(mt), 1});
+    --sz;
+  }
+}
+
 void ConstructLinearMap(std::map<int, int>& mp, int sz) {
   while(sz) {
     mp.insert(std::pair{sz, 1});
@@ -78,6 +131,240 @@ void BM_StdMapLinearInsert(benchmark::State& state) {
   state.SetComplexityN(state.range(0));
 }
 
+void BM_AvlMapRandomInsert(benchmark::State& state) {
+  Map<int, int, std::less<int>, AvlBalance> mp;
+  for (auto _ : state) {
+    ConstructRandomMap(mp, state.range(0));
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+void BM_AvlMapLinearInsert(benchmark::State& state) {
+  Map<int, int, std::less<int>, AvlBalance> mp;
+  for (auto _ : state) {
+    ConstructLinearMap(mp, state.range(0));
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+void BM_BTreeMapRandomInsert(benchmark::State& state) {
+  BTreeMap<int, int> mp;
+  for (auto _ : state) {
+    ConstructRandomMap(mp, state.range(0));
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+// Each iteration fills a fresh table, so the timings include its growth
+void BM_HashMapRandomInsert(benchmark::State& state) {
+  for (auto _ : state) {
+    HashMap<int, int> mp;
+    ConstructRandomMap(mp, state.range(0));
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+void BM_HashMapReservedRandomInsert(benchmark::State& state) {
+  for (auto _ : state) {
+    HashMap<int, int> mp;
+    mp.Reserve(state.range(0));
+    ConstructRandomMap(mp, state.range(0));
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+void BM_StdUnorderedMapRandomInsert(benchmark::State& state) {
+  for (auto _ : state) {
+    std::unordered_map<int, int> mp;
+    ConstructRandomMap(mp, state.range(0));
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+void BM_BTreeMapLinearInsert(benchmark::State& state) {
+  BTreeMap<int, int> mp;
+  for (auto _ : state) {
+    ConstructLinearMap(mp, state.range(0));
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+// Lookups of present keys in random order over a map of state.range(0) keys
+template <typename MapType, typename Lookup>
+void RunFind(benchmark::State& state, Lookup lookup) {
+  MapType mp;
+  std::vector<int> keys(state.range(0));
+  std::mt19937 mt(17);
+  for (auto& key : keys) {
+    key = static_cast<int>(mt());
+    mp[key] = 1;
+  }
+  std::shuffle(keys.begin(), keys.end(), mt);
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(lookup(mp, keys[i]));
+    if (++i == keys.size()) {
+      i = 0;
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.SetComplexityN(state.range(0));
+}
+
+void BM_CustomMapFind(benchmark::State& state) {
+  RunFind<Map<int, int>>(state, [](const Map<int, int>& mp, int key) { return mp.Find(key); });
+}
+
+void BM_BTreeMapFind(benchmark::State& state) {
+  RunFind<BTreeMap<int, int>>(state, [](const BTreeMap<int, int>& mp, int key) { return mp.Find(key); });
+}
+
+void BM_StdMapFind(benchmark::State& state) {
+  RunFind<std::map<int, int>>(state, [](const std::map<int, int>& mp, int key) { return mp.find(key) != mp.end(); });
+}
+
+void BM_HashMapFind(benchmark::State& state) {
+  RunFind<HashMap<int, int>>(state, [](const HashMap<int, int>& mp, int key) { return mp.Find(key); });
+}
+
+void BM_StdUnorderedMapFind(benchmark::State& state) {
+  RunFind<std::unordered_map<int, int>>(
+      state, [](const std::unordered_map<int, int>& mp, int key) { return mp.find(key) != mp.end(); });
+}
+
+// Looks up kFindManyKeys keys per iteration, a window into a pool of random present keys
+// Draws ranks 0..n-1 with P(k) proportional to 1 / (k + 1)^exponent: rank 0 is the hottest.
+// An exponent of 0 is uniform; around 1 a few ranks take most of the draws.
+class ZipfGenerator {
+ public:
+  ZipfGenerator(size_t n, double exponent) : cdf_(n) {
+    double total = 0;
+    for (size_t k = 0; k < n; ++k) {
+      total += 1.0 / std::pow(static_cast<double>(k + 1), exponent);
+      cdf_[k] = total;
+    }
+    for (auto& p : cdf_) {
+      p /= total;
+    }
+  }
+
+  size_t operator()(std::mt19937& mt) const {
+    double p = std::uniform_real_distribution<double>(0, 1)(mt);
+    auto it = std::lower_bound(cdf_.begin(), cdf_.end(), p);
+    return std::min(static_cast<size_t>(it - cdf_.begin()), cdf_.size() - 1);
+  }
+
+ private:
+  std::vector<double> cdf_;
+};
+
+// Present keys looked up with Zipfian popularity: range(0) keys, exponent range(1) / 100.
+// The hot keys are spread over the key space, not clustered at one end of it.
+template <typename MapType>
+void RunZipfFind(benchmark::State& state) {
+  constexpr size_t kLookups = 1 << 16;
+  MapType mp;
+  std::vector<int> keys(state.range(0));
+  std::mt19937 mt(17);
+  for (auto& key : keys) {
+    key = static_cast<int>(mt());
+    mp[key] = 1;
+  }
+  std::shuffle(keys.begin(), keys.end(), mt);
+  ZipfGenerator zipf(keys.size(), static_cast<double>(state.range(1)) / 100);
+  std::vector<int> lookups(kLookups);
+  for (auto& key : lookups) {
+    key = keys[zipf(mt)];
+  }
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(mp.Find(lookups[i]));
+    if (++i == lookups.size()) {
+      i = 0;
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+void BM_CustomMapZipfFind(benchmark::State& state) {
+  RunZipfFind<Map<int, int>>(state);
+}
+
+void BM_AvlMapZipfFind(benchmark::State& state) {
+  RunZipfFind<Map<int, int, std::less<int>, AvlBalance>>(state);
+}
+
+void BM_SplayMapZipfFind(benchmark::State& state) {
+  RunZipfFind<Map<int, int, std::less<int>, SplayBalance>>(state);
+}
+
+template <bool kBatched>
+void RunFindMany(benchmark::State& state) {
+  constexpr size_t kFindManyKeys = 1024;
+  constexpr size_t kPoolKeys = 1 << 16;
+  Map<int, int> mp;
+  std::vector<int> present(state.range(0));
+  std::mt19937 mt(17);
+  for (auto& key : present) {
+    key = static_cast<int>(mt());
+    mp[key] = 1;
+  }
+  std::vector<int> pool(kPoolKeys);
+  std::uniform_int_distribution<size_t> pick(0, present.size() - 1);
+  for (auto& key : pool) {
+    key = present[pick(mt)];
+  }
+  std::vector<Map<int, int>::MapIterator> found(kFindManyKeys);
+  size_t first = 0;
+  for (auto _ : state) {
+    std::span<const int> keys(pool.data() + first, kFindManyKeys);
+    if constexpr (kBatched) {
+      mp.FindMany(keys, found);
+    } else {
+      for (int key : keys) {
+        benchmark::DoNotOptimize(mp.Find(key));
+      }
+    }
+    benchmark::DoNotOptimize(found.data());
+    first = (first + kFindManyKeys) % kPoolKeys;
+  }
+  state.SetItemsProcessed(state.iterations() * kFindManyKeys);
+  state.SetComplexityN(state.range(0));
+}
+
+void BM_CustomMapFindLoop(benchmark::State& state) {
+  RunFindMany<false>(state);
+}
+
+void BM_CustomMapFindMany(benchmark::State& state) {
+  RunFindMany<true>(state);
+}
+
+// Same lookups as RunFind, in a FrozenMap built from the Map (which is freed before timing)
+void BM_FrozenMapFind(benchmark::State& state) {
+  std::vector<int> keys(state.range(0));
+  FrozenMap<int, int> frozen;
+  {
+    Map<int, int> mp;
+    std::mt19937 mt(17);
+    for (auto& key : keys) {
+      key = static_cast<int>(mt());
+      mp[key] = 1;
+    }
+    std::shuffle(keys.begin(), keys.end(), mt);
+    frozen = FrozenMap<int, int>(mp);
+  }
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(frozen.Find(keys[i]));
+    if (++i == keys.size()) {
+      i = 0;
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.SetComplexityN(state.range(0));
+}
+
 void BM_CustomMapErase(benchmark::State& state) {
   Map<int, int> mp;
   std::random_device rd;
@@ -123,6 +410,17 @@ void BM_CustomMapClear(benchmark::State& state) {
   state.SetComplexityN(state.range(0));
 }
 
+// Slots go back to the shared pool's free list one by one; no chunk is freed
+void BM_CustomMapSharedPoolClear(benchmark::State& state) {
+  Map<int, int>::Pool pool;
+  Map<int, int> mp(pool);
+  for (auto _ : state) {
+    ConstructRandomMap(mp, state.range(0));
+    mp.Clear();
+  }
+  state.SetComplexityN(state.range(0));
+}
+
 void BM_StdMapClear(benchmark::State& state) {
   std::map<int, int> mp;
   for (auto _ : state) {
@@ -132,14 +430,569 @@ void BM_StdMapClear(benchmark::State& state) {
   state.SetComplexityN(state.range(0));
 }
 
+// Only the Clear() call is timed. With nodes in the map's own NodePool, clearing 1<<20 nodes
+// went from ~26 ms (one delete per node) to ~3 ms (the pool drops its chunks at once).
+template <typename MapType, typename ClearFn>
+void RunClearOnly(benchmark::State& state, ClearFn clear) {
+  MapType mp;
+  for (auto _ : state) {
+    state.PauseTiming();
+    ConstructLinearMap(mp, state.range(0));
+    state.ResumeTiming();
+    clear(mp);
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+void BM_CustomMapClearOnly(benchmark::State& state) {
+  RunClearOnly<Map<int, int>>(state, [](Map<int, int>& mp) { mp.Clear(); });
+}
+
+void BM_StdMapClearOnly(benchmark::State& state) {
+  RunClearOnly<std::map<int, int>>(state, [](std::map<int, int>& mp) { mp.clear(); });
+}
+
+// Keys longer than the small-string buffer, so every temporary std::string allocates
+std::vector<std::string> LongKeys(int sz) {
+  std::vector<std::string> keys;
+  keys.reserve(sz);
+  std::mt19937 mt(23);
+  for (int i = 0; i < sz; ++i) {
+    keys.push_back(fmt::format("series/{:08x}/{:016x}", mt(), i));
+  }
+  return keys;
+}
+
+// Looks up string_views of present keys; allocs_per_lookup counts temporary std::string buffers
+template <typename Compare, typename Lookup>
+void RunStringViewFind(benchmark::State& state, Lookup lookup) {
+  auto keys = LongKeys(state.range(0));
+  Map<std::string, int, Compare> mp;
+  for (const auto& key : keys) {
+    mp[key] = 1;
+  }
+  std::vector<std::string_view> views(keys.begin(), keys.end());
+  std::shuffle(views.begin(), views.end(), std::mt19937(3));
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(lookup(mp, views[i]));
+    if (++i == views.size()) {
+      i = 0;
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.SetComplexityN(state.range(0));
+}
+
+void BM_CustomMapStringViewFind(benchmark::State& state) {
+  RunStringViewFind<std::less<>>(state, [](const Map<std::string, int, std::less<>>& mp, std::string_view key) {
+    return mp.Contains(key);
+  });
+  state.counters["allocs_per_lookup"] = 0;
+}
+
+void BM_CustomMapStringCopyFind(benchmark::State& state) {
+  RunStringViewFind<std::less<std::string>>(state, [](const Map<std::string, int>& mp, std::string_view key) {
+    return mp.Contains(std::string(key));
+  });
+  state.counters["allocs_per_lookup"] = 1;
+}
+
+std::vector<std::pair<int, int>> SortedEntries(int sz) {
+  std::vector<std::pair<int, int>> entries;
+  entries.reserve(sz);
+  for (int i = 0; i < sz; ++i) {
+    entries.emplace_back(i, i);
+  }
+  return entries;
+}
+
+// Restoring a map from a sorted dump
+void BM_CustomMapBuildFromSorted(benchmark::State& state) {
+  auto entries = SortedEntries(state.range(0));
+  for (auto _ : state) {
+    auto mp = Map<int, int>::BuildFromSorted(entries.begin(), entries.end());
+    benchmark::DoNotOptimize(mp.Size());
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+void BM_CustomMapInsertSorted(benchmark::State& state) {
+  auto entries = SortedEntries(state.range(0));
+  for (auto _ : state) {
+    Map<int, int> mp;
+    for (const auto& entry : entries) {
+      mp.Insert(entry);
+    }
+    benchmark::DoNotOptimize(mp.Size());
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+void BM_CustomMapBuildFromUnsorted(benchmark::State& state) {
+  auto entries = SortedEntries(state.range(0));
+  std::shuffle(entries.begin(), entries.end(), std::mt19937(5));
+  for (auto _ : state) {
+    auto mp = Map<int, int>::BuildFromUnsorted(entries.begin(), entries.end());
+    benchmark::DoNotOptimize(mp.Size());
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+// Sums the values of the 16 keys following a random point, as a time-series query would
+void BM_CustomMapRangeQuery(benchmark::State& state) {
+  Map<int, int> mp;
+  for (int i = 0; i < state.range(0); ++i) {
+    mp.Insert({i * 10, i});
+  }
+  std::mt19937 mt(9);
+  for (auto _ : state) {
+    int from = static_cast<int>(mt() % (state.range(0) * 10));
+    int64_t sum = 0;
+    for (const auto& [key, value] : mp.Range(from, from + 160)) {
+      sum += value;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.SetComplexityN(state.range(0));
+}
+
+// The same query answered by scanning a copy of the whole map
+void BM_CustomMapValuesScanQuery(benchmark::State& state) {
+  Map<int, int> mp;
+  for (int i = 0; i < state.range(0); ++i) {
+    mp.Insert({i * 10, i});
+  }
+  std::mt19937 mt(9);
+  for (auto _ : state) {
+    int from = static_cast<int>(mt() % (state.range(0) * 10));
+    int64_t sum = 0;
+    for (const auto& [key, value] : mp.Values()) {
+      if (key >= from && key < from + 160) {
+        sum += value;
+      }
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.SetComplexityN(state.range(0));
+}
+
+// Time ranges of up to 100 ticks starting every 10 ticks on average: a point falls into ~5 of them
+void ConstructTimeRanges(IntervalMap<int, int>& map, int sz) {
+  std::mt19937 mt(21);
+  std::uniform_int_distribution<int> starts(0, sz * 10);
+  std::uniform_int_distribution<int> lengths(0, 100);
+  for (int i = 0; i < sz; ++i) {
+    int low = starts(mt);
+    map.Insert({{low, low + lengths(mt)}, i});
+  }
+}
+
+// Sums the values of the ranges that contain a random point
+void BM_IntervalMapStab(benchmark::State& state) {
+  IntervalMap<int, int> map;
+  ConstructTimeRanges(map, state.range(0));
+  std::mt19937 mt(9);
+  for (auto _ : state) {
+    int point = static_cast<int>(mt() % (state.range(0) * 10));
+    int64_t sum = 0;
+    map.ForEachOverlap(point, point, [&sum](const auto& entry) { sum += entry.second; });
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.SetComplexityN(state.range(0));
+}
+
+// The same query answered by scanning a copy of every range
+void BM_IntervalMapScanValues(benchmark::State& state) {
+  IntervalMap<int, int> map;
+  ConstructTimeRanges(map, state.range(0));
+  std::mt19937 mt(9);
+  for (auto _ : state) {
+    int point = static_cast<int>(mt() % (state.range(0) * 10));
+    int64_t sum = 0;
+    for (const auto& [interval, value] : map.Values()) {
+      if (interval.low <= point && point <= interval.high) {
+        sum += value;
+      }
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.SetComplexityN(state.range(0));
+}
+
+// Percentile query over a changing set: one update and one k-th smallest lookup per iteration
+void BM_CustomMapSelect(benchmark::State& state) {
+  Map<int, int, std::less<int>, RedBlackBalance, SubtreeSize> mp;
+  ConstructRandomMap(mp, state.range(0));
+  std::mt19937 mt(13);
+  for (auto _ : state) {
+    mp.Insert({static_cast<int>(mt()), 1});
+    benchmark::DoNotOptimize(mp.Select(mp.Size() * 99 / 100)->first);
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.SetComplexityN(state.range(0));
+}
+
+// The same query by copying Values() and indexing into the copy
+void BM_CustomMapSelectByValues(benchmark::State& state) {
+  Map<int, int> mp;
+  ConstructRandomMap(mp, state.range(0));
+  std::mt19937 mt(13);
+  for (auto _ : state) {
+    mp.Insert({static_cast<int>(mt()), 1});
+    auto values = mp.Values();
+    benchmark::DoNotOptimize(values[values.size() * 99 / 100].first);
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.SetComplexityN(state.range(0));
+}
+
+// Appends increasing keys with End() as the hint
+void BM_CustomMapHintedAppend(benchmark::State& state) {
+  for (auto _ : state) {
+    Map<int, int> mp;
+    for (int i = 0; i < state.range(0); ++i) {
+      mp.Insert(mp.End(), {i, i});
+    }
+    benchmark::DoNotOptimize(mp.Size());
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+// Counts word occurrences: Find-then-Insert descends twice, TryEmplace once
+void BM_CustomMapCheckThenInsert(benchmark::State& state) {
+  std::vector<int> words(state.range(0));
+  std::mt19937 mt(2);
+  for (auto& word : words) {
+    word = static_cast<int>(mt() % (state.range(0) / 4 + 1));
+  }
+  for (auto _ : state) {
+    Map<int, int> mp;
+    for (int word : words) {
+      if (!mp.Find(word)) {
+        mp.Insert({word, 0});
+      }
+    }
+    benchmark::DoNotOptimize(mp.Size());
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+void BM_CustomMapTryEmplace(benchmark::State& state) {
+  std::vector<int> words(state.range(0));
+  std::mt19937 mt(2);
+  for (auto& word : words) {
+    word = static_cast<int>(mt() % (state.range(0) / 4 + 1));
+  }
+  for (auto _ : state) {
+    Map<int, int> mp;
+    for (int word : words) {
+      mp.TryEmplace(word, 0);
+    }
+    benchmark::DoNotOptimize(mp.Size());
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+// Sums every value in key order. heap_bytes is the buffer one pass needs besides the tree.
+void BM_CustomMapIterateValues(benchmark::State& state) {
+  Map<int, int> mp;
+  ConstructRandomMap(mp, state.range(0));
+  size_t bytes = 0;
+  for (auto _ : state) {
+    auto values = mp.Values();
+    int64_t sum = 0;
+    for (const auto& [key, value] : values) {
+      sum += value;
+    }
+    benchmark::DoNotOptimize(sum);
+    bytes = values.capacity() * sizeof(values[0]);
+  }
+  state.counters["heap_bytes"] = static_cast<double>(bytes);
+  state.SetItemsProcessed(state.iterations() * mp.Size());
+  state.SetComplexityN(state.range(0));
+}
+
+void BM_CustomMapIterateView(benchmark::State& state) {
+  Map<int, int> mp;
+  ConstructRandomMap(mp, state.range(0));
+  for (auto _ : state) {
+    int64_t sum = 0;
+    for (const auto& [key, value] : mp.Ascending()) {
+      sum += value;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.counters["heap_bytes"] = 0;
+  state.SetItemsProcessed(state.iterations() * mp.Size());
+  state.SetComplexityN(state.range(0));
+}
+
+
+// Moves the keys from a random one up into another map and back. Shared pool and subtree sizes
+// make Split O(log n); the baseline moves every such entry by Insert and Erase.
+void BM_CustomMapSplitJoin(benchmark::State& state) {
+  using SizedMap = Map<int, int, std::less<int>, RedBlackBalance, SubtreeSize>;
+  SizedMap mp;
+  for (int i = 0; i < state.range(0); ++i) {
+    mp.Insert({i, i});
+  }
+  std::mt19937 mt(42);
+  for (auto _ : state) {
+    SizedMap right = mp.Split(static_cast<int>(mt() % state.range(0)));
+    mp = SizedMap::Join(std::move(mp), std::move(right));
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+void BM_CustomMapMoveRangeByInsert(benchmark::State& state) {
+  Map<int, int> mp;
+  for (int i = 0; i < state.range(0); ++i) {
+    mp.Insert({i, i});
+  }
+  std::mt19937 mt(42);
+  for (auto _ : state) {
+    Map<int, int> right;
+    int key = static_cast<int>(mt() % state.range(0));
+    for (const auto& entry : mp.Range(key, static_cast<int>(state.range(0)))) {
+      right.Insert(entry);
+    }
+    for (int i = key; i < state.range(0); ++i) {
+      mp.Erase(i);
+    }
+    for (const auto& entry : right.Ascending()) {
+      mp.Insert(entry);
+    }
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+// Merges a map of n / range(1) random keys into a map of n keys; building the inputs is not timed
+template <typename MergeFn>
+void RunMerge(benchmark::State& state, MergeFn merge) {
+  Map<int, int> big;
+  Map<int, int> small;
+  ConstructRandomMap(big, state.range(0));
+  ConstructRandomMap(small, state.range(0) / state.range(1));
+  for (auto _ : state) {
+    state.PauseTiming();
+    Map<int, int> lhs(big);
+    Map<int, int> rhs(small);
+    state.ResumeTiming();
+    merge(lhs, rhs);
+    benchmark::DoNotOptimize(lhs.Size());
+    state.PauseTiming();
+    lhs.Clear();
+    rhs.Clear();
+    state.ResumeTiming();
+  }
+}
+
+void BM_CustomMapUnion(benchmark::State& state) {
+  RunMerge(state, [](Map<int, int>& lhs, Map<int, int>& rhs) { lhs.Union(std::move(rhs)); });
+}
+
+void BM_CustomMapUnionByInsert(benchmark::State& state) {
+  RunMerge(state, [](Map<int, int>& lhs, Map<int, int>& rhs) {
+    for (const auto& entry : rhs.Ascending()) {
+      lhs.Insert(entry);
+    }
+  });
+}
+
+// Point-in-time copy for an export: a full tree copy against an O(1) persistent snapshot
+void BM_CustomMapCopy(benchmark::State& state) {
+  Map<int, int> mp;
+  ConstructRandomMap(mp, state.range(0));
+  for (auto _ : state) {
+    Map<int, int> copy(mp);
+    benchmark::DoNotOptimize(copy.Size());
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+void BM_PersistentMapSnapshot(benchmark::State& state) {
+  PersistentMap<int, int> mp;
+  std::mt19937 mt(42);
+  for (int i = 0; i < state.range(0); ++i) {
+    mp.Insert({static_cast<int>(mt()), i});
+  }
+  for (auto _ : state) {
+    auto snapshot = mp.Snapshot();
+    benchmark::DoNotOptimize(snapshot.Size());
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+// Writes while a snapshot is alive: each one copies its path, O(log n) nodes
+void BM_PersistentMapInsertWithSnapshot(benchmark::State& state) {
+  PersistentMap<int, int> mp;
+  std::mt19937 mt(42);
+  for (int i = 0; i < state.range(0); ++i) {
+    mp.Insert({static_cast<int>(mt()), i});
+  }
+  for (auto _ : state) {
+    auto snapshot = mp.Snapshot();
+    mp.Insert({static_cast<int>(mt()), 0});
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+void BM_PersistentMapInsert(benchmark::State& state) {
+  PersistentMap<int, int> mp;
+  std::mt19937 mt(42);
+  for (int i = 0; i < state.range(0); ++i) {
+    mp.Insert({static_cast<int>(mt()), i});
+  }
+  for (auto _ : state) {
+    mp.Insert({static_cast<int>(mt()), 0});
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+// Multi-threaded workloads over one shared map, prefilled with kConcurrentKeys keys.
+// Each thread writes only its own keys, inserting and then erasing them in turn, so Erase never misses.
+constexpr int kConcurrentKeys = 1 << 16;
+
+class LockedMap {
+public:
+  bool Find(int key) const {
+    std::shared_lock lock(mutex_);
+    return map_.Find(key);
+  }
+
+  void Insert(const std::pair<const int, int>& value) {
+    std::unique_lock lock(mutex_);
+    map_.Insert(value);
+  }
+
+  void Erase(int key) {
+    std::unique_lock lock(mutex_);
+    map_.Erase(key);
+  }
+
+private:
+  Map<int, int> map_;
+  mutable std::shared_mutex mutex_;
+};
+
+template <typename MapType>
+void RunConcurrent(benchmark::State& state, int write_percent) {
+  static MapType* mp = nullptr;
+  if (state.thread_index() == 0) {
+    mp = new MapType();
+    for (int i = 0; i < kConcurrentKeys; ++i) {
+      mp->Insert({i * 2, i});
+    }
+  }
+  std::mt19937 mt(state.thread_index());
+  int own_key = kConcurrentKeys * 2 + state.thread_index() * 2 + 1;
+  bool inserted = false;
+  for (auto _ : state) {
+    if (static_cast<int>(mt() % 100) < write_percent) {
+      if (inserted) {
+        mp->Erase(own_key);
+        own_key += 2 * state.threads();
+      } else {
+        mp->Insert({own_key, 0});
+      }
+      inserted = !inserted;
+    } else {
+      benchmark::DoNotOptimize(mp->Find(static_cast<int>(mt() % (kConcurrentKeys * 2))));
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+  if (state.thread_index() == 0) {
+    delete mp;
+  }
+}
+
+void BM_LockedMapReadHeavy(benchmark::State& state) {
+  RunConcurrent<LockedMap>(state, 5);
+}
+
+void BM_ConcurrentMapReadHeavy(benchmark::State& state) {
+  RunConcurrent<ConcurrentMap<int, int>>(state, 5);
+}
+
+void BM_LockedMapMixed(benchmark::State& state) {
+  RunConcurrent<LockedMap>(state, 50);
+}
+
+void BM_ConcurrentMapMixed(benchmark::State& state) {
+  RunConcurrent<ConcurrentMap<int, int>>(state, 50);
+}
+
 
 BENCHMARK(BM_CustomMapRandomInsert)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
 BENCHMARK(BM_StdMapRandomInsert)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
-BENCHMARK(BM_CustomMapLinearInsert)->Range(1<<10, 1<<15)->Complexity()->Unit(benchmark::kMillisecond);
-BENCHMARK(BM_StdMapLinearInsert)->Range(1<<10, 1<<15)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CustomMapLinearInsert)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_StdMapLinearInsert)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_AvlMapRandomInsert)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_AvlMapLinearInsert)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_BTreeMapRandomInsert)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_BTreeMapLinearInsert)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_HashMapRandomInsert)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_HashMapReservedRandomInsert)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_StdUnorderedMapRandomInsert)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CustomMapFind)->Range(1<<10, 1<<24)->Complexity(benchmark::oLogN);
+BENCHMARK(BM_BTreeMapFind)->Range(1<<10, 1<<24)->Complexity(benchmark::oLogN);
+BENCHMARK(BM_StdMapFind)->Range(1<<10, 1<<24)->Complexity(benchmark::oLogN);
+BENCHMARK(BM_CustomMapFindLoop)->RangeMultiplier(8)->Range(1<<10, 1<<24)->Complexity(benchmark::oLogN);
+BENCHMARK(BM_CustomMapFindMany)->RangeMultiplier(8)->Range(1<<10, 1<<24)->Complexity(benchmark::oLogN);
+BENCHMARK(BM_CustomMapZipfFind)->ArgsProduct({{1<<12, 1<<16, 1<<20}, {0, 99, 120, 150}});
+BENCHMARK(BM_AvlMapZipfFind)->ArgsProduct({{1<<12, 1<<16, 1<<20}, {0, 99, 120, 150}});
+BENCHMARK(BM_SplayMapZipfFind)->ArgsProduct({{1<<12, 1<<16, 1<<20}, {0, 99, 120, 150}});
+BENCHMARK(BM_FrozenMapFind)->Range(1<<10, 1<<24)->Complexity(benchmark::oLogN);
+BENCHMARK(BM_HashMapFind)->Range(1<<10, 1<<24)->Complexity(benchmark::o1);
+BENCHMARK(BM_StdUnorderedMapFind)->Range(1<<10, 1<<24)->Complexity(benchmark::o1);
 BENCHMARK(BM_CustomMapErase)->Range(1<<10, 1<<17)->Complexity()->Unit(benchmark::kMillisecond);
 BENCHMARK(BM_StdMapErase)->Range(1<<10, 1<<17)->Complexity()->Unit(benchmark::kMillisecond);
 BENCHMARK(BM_CustomMapClear)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CustomMapSharedPoolClear)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
 BENCHMARK(BM_StdMapClear)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CustomMapClearOnly)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_StdMapClearOnly)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_CustomMapIterateValues)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CustomMapIterateView)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_CustomMapBuildFromSorted)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CustomMapInsertSorted)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CustomMapBuildFromUnsorted)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_CustomMapStringViewFind)->Range(1<<10, 1<<20)->Complexity(benchmark::oLogN);
+BENCHMARK(BM_CustomMapStringCopyFind)->Range(1<<10, 1<<20)->Complexity(benchmark::oLogN);
+
+BENCHMARK(BM_CustomMapRangeQuery)->Range(1<<10, 1<<20)->Complexity(benchmark::oLogN);
+BENCHMARK(BM_CustomMapValuesScanQuery)->Range(1<<10, 1<<18)->Complexity(benchmark::oN);
+BENCHMARK(BM_IntervalMapStab)->Range(1<<10, 1<<20)->Complexity(benchmark::oLogN);
+BENCHMARK(BM_IntervalMapScanValues)->Range(1<<10, 1<<18)->Complexity(benchmark::oN);
+
+BENCHMARK(BM_CustomMapSelect)->Range(1<<10, 1<<20)->Complexity(benchmark::oLogN);
+BENCHMARK(BM_CustomMapSelectByValues)->Range(1<<10, 1<<18)->Complexity(benchmark::oN);
+
+BENCHMARK(BM_CustomMapHintedAppend)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CustomMapCheckThenInsert)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CustomMapTryEmplace)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_CustomMapSplitJoin)->Range(1<<10, 1<<20)->Complexity(benchmark::oLogN);
+BENCHMARK(BM_CustomMapMoveRangeByInsert)->Range(1<<10, 1<<18)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CustomMapUnion)->ArgsProduct({{1<<14, 1<<20}, {1, 16, 1024}})->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CustomMapUnionByInsert)->ArgsProduct({{1<<14, 1<<20}, {1, 16, 1024}})->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_CustomMapCopy)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_PersistentMapSnapshot)->Range(1<<10, 1<<20)->Complexity(benchmark::o1);
+BENCHMARK(BM_PersistentMapInsertWithSnapshot)->Range(1<<10, 1<<20)->Complexity(benchmark::oLogN);
+BENCHMARK(BM_PersistentMapInsert)->Range(1<<10, 1<<20)->Complexity(benchmark::oLogN);
+
+BENCHMARK(BM_LockedMapReadHeavy)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK(BM_ConcurrentMapReadHeavy)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK(BM_LockedMapMixed)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK(BM_ConcurrentMapMixed)->ThreadRange(1, 64)->UseRealTime();
 
 BENCHMARK_MAIN();
\ No newline at end of file
@@ -1,14 +1,32 @@
+#include <algorithm>
+#include <atomic>
+#include <bit>
 #include <chrono>
+#include <cstdint>
 #include <future>
+#include <iterator>
 #include <map>
+#include <memory>
+#include <optional>
 #include <iostream>
+#include <random>
+#include <span>
 #include <string>
+#include <string_view>
 #include <thread>
+#include <tuple>
+#include <vector>
 
 #include <fmt/core.h>
 #include <gtest/gtest.h>
 
+#include "../btree_map.hpp"
+#include "../concurrent_map.hpp"
+#include "../frozen_map.hpp"
+#include "../hash_map.hpp"
+#include "../interval_map.hpp"
 #include "../map.hpp"
+#include "../persistent_map.hpp"
 
 class MapTest: public testing::Test {
   protected:
@@ -213,6 +231,47 @@ TEST_F(MapTest, FindNotExistValue) {
   ASSERT_FALSE(mp.Find(-11));
 }
 
+TEST_F(MapTest, FindMany) {
+  std::vector<int> keys = {90, -11, 1, 1, 4, -10, 0, 91};
+  std::vector<Map<int, int>::MapIterator> found(keys.size());
+  mp.FindMany(keys, found);
+  for (size_t i = 0; i < keys.size(); ++i) {
+    if (mp.Find(keys[i])) {
+      ASSERT_EQ(found[i], mp.LowerBound(keys[i]));
+    } else {
+      ASSERT_EQ(found[i], mp.End());
+    }
+  }
+  ASSERT_THROW(mp.FindMany(keys, std::span(found).first(3)), std::runtime_error);
+
+  Map<int, int> empty;
+  empty.FindMany(keys, found);
+  ASSERT_TRUE(std::all_of(found.begin(), found.end(), [&empty](const auto& it) { return it == empty.End(); }));
+}
+
+TEST(FindManyTest, MatchesFind) {
+  Map<int, int> map;
+  std::mt19937 mt(99);
+  for (int i = 0; i < 20000; ++i) {
+    map[static_cast<int>(mt() % 100000)] = i;
+  }
+  // More keys than searches in flight, with hits, misses and repeats
+  std::vector<int> keys(5000);
+  for (auto& key : keys) {
+    key = static_cast<int>(mt() % 100000);
+  }
+  std::vector<Map<int, int>::MapIterator> found(keys.size());
+  map.FindMany(keys, found);
+  for (size_t i = 0; i < keys.size(); ++i) {
+    if (map.Find(keys[i])) {
+      ASSERT_EQ(found[i]->first, keys[i]);
+      ASSERT_EQ(found[i]->second, map[keys[i]]);
+    } else {
+      ASSERT_EQ(found[i], map.End());
+    }
+  }
+}
+
 TEST_F(MapTest, EraseLeaf) {
   mp.Erase(0);
   ASSERT_EQ(mp.Size(), sz - 1);
@@ -336,6 +395,1292 @@ TEST_F(MapTest, CustomComparator) {
 }
 
 
+template <typename MapType>
+void CheckAgainstStdMap() {
+  MapType map;
+  std::map<int, int> expected;
+  std::mt19937 mt(123);
+  std::uniform_int_distribution<int> keys(0, 2000);
+  for (int i = 0; i < 20000; ++i) {
+    int key = keys(mt);
+    switch (mt() % 3) {
+      case 0:
+        map.Insert({key, i});
+        expected[key] = i;
+        break;
+      case 1:
+        map[key] += 1;
+        expected[key] += 1;
+        break;
+      default:
+        if (expected.erase(key) != 0) {
+          map.Erase(key);
+        } else {
+          ASSERT_ANY_THROW(map.Erase(key));
+        }
+    }
+    ASSERT_EQ(map.Find(key), expected.contains(key));
+  }
+  ASSERT_EQ(map.Size(), expected.size());
+  auto values = map.Values(true);
+  ASSERT_TRUE(std::equal(values.begin(), values.end(), expected.begin(), expected.end()));
+
+  MapType copy = map;
+  map.Clear();
+  auto copied = copy.Values(false);
+  ASSERT_TRUE(std::equal(copied.begin(), copied.end(), expected.rbegin(), expected.rend()));
+}
+
+TEST(BalancedMapTest, RedBlackMatchesStdMap) {
+  CheckAgainstStdMap<Map<int, int, std::less<int>, RedBlackBalance>>();
+}
+
+TEST(BalancedMapTest, AvlMatchesStdMap) {
+  CheckAgainstStdMap<Map<int, int, std::less<int>, AvlBalance>>();
+}
+
+TEST(BalancedMapTest, SplayMatchesStdMap) {
+  CheckAgainstStdMap<Map<int, int, std::less<int>, SplayBalance>>();
+}
+
+// Sorted inserts leave a splay tree as a single path; walking it in order through Find must
+// still take amortized O(1) per key, and lookups through a const reference reshape it too
+TEST(BalancedMapTest, SplaySequentialAccess) {
+  const int n = 1 << 18;
+  using SplayMap = Map<int, int, std::less<int>, SplayBalance, SubtreeSize>;
+  SplayMap map;
+  for (int i = 0; i < n; ++i) {
+    map.Insert({i, i});
+  }
+  const SplayMap& view = map;
+  for (int i = 0; i < n; ++i) {
+    ASSERT_TRUE(view.Find(i));
+  }
+  ASSERT_FALSE(view.Contains(n));
+  ASSERT_EQ(map.Size(), n);
+  int expected = 0;
+  for (const auto& [key, value] : map.Ascending()) {
+    ASSERT_EQ(key, expected++);
+  }
+  ASSERT_EQ(expected, n);
+  auto tail = map.Split(n / 2);
+  ASSERT_EQ(map.Size() + tail.Size(), n);
+  ASSERT_EQ(tail.Begin()->first, n / 2);
+}
+
+// A degenerate tree would need ~n^2/2 comparisons here and time out
+// Map befriends its augmentation, so this one can walk the nodes: it measures the height and
+// checks the balancing invariants without widening the public API
+struct TreeAudit : NoAugment {
+  template <typename Tree>
+  static int Height(const Tree& tree) {
+    return HeightOf(tree.root_);
+  }
+
+  template <typename Tree>
+  static bool IsRedBlack(const Tree& tree) {
+    return (tree.root_ == nullptr || !tree.root_->meta.red) && BlackHeight(tree.root_) >= 0;
+  }
+
+  template <typename Tree>
+  static bool IsAvl(const Tree& tree) {
+    return AvlHeight(tree.root_) >= 0;
+  }
+
+ private:
+  template <typename Node>
+  static int HeightOf(const Node* node) {
+    return node == nullptr ? 0 : 1 + std::max(HeightOf(node->left), HeightOf(node->right));
+  }
+
+  // Black nodes on every path down, -1 if a red node has a red child or two paths differ
+  template <typename Node>
+  static int BlackHeight(const Node* node) {
+    if (node == nullptr) {
+      return 1;
+    }
+    for (const Node* child : {node->left, node->right}) {
+      if (node->meta.red && child != nullptr && child->meta.red) {
+        return -1;
+      }
+    }
+    int left = BlackHeight(node->left);
+    int right = BlackHeight(node->right);
+    if (left < 0 || left != right) {
+      return -1;
+    }
+    return left + (node->meta.red ? 0 : 1);
+  }
+
+  // Height of the subtree, -1 if a stored height is stale or the children differ by more than one
+  template <typename Node>
+  static int AvlHeight(const Node* node) {
+    if (node == nullptr) {
+      return 0;
+    }
+    int left = AvlHeight(node->left);
+    int right = AvlHeight(node->right);
+    if (left < 0 || right < 0 || std::abs(left - right) > 1) {
+      return -1;
+    }
+    int height = std::max(left, right) + 1;
+    return node->meta.height == height ? height : -1;
+  }
+};
+
+TEST(BalancedMapTest, SortedInsertKeepsTreeShallow) {
+  const int n = 1 << 16;
+  const int log_n = std::bit_width(static_cast<unsigned>(n));
+  Map<int, int, std::less<int>, RedBlackBalance, TreeAudit> increasing;
+  Map<int, int, std::less<int>, AvlBalance, TreeAudit> decreasing;
+  for (int i = 0; i < n; ++i) {
+    increasing.Insert({i, i});
+    decreasing.Insert({n - i, i});
+  }
+  ASSERT_TRUE(TreeAudit::IsRedBlack(increasing));
+  ASSERT_LE(TreeAudit::Height(increasing), 2 * log_n);
+  ASSERT_TRUE(TreeAudit::IsAvl(decreasing));
+  ASSERT_LE(TreeAudit::Height(decreasing) * 100, 145 * log_n);
+
+  for (int i = 0; i < n; i += 2) {
+    increasing.Erase(i);
+    decreasing.Erase(n - i);
+  }
+  ASSERT_TRUE(TreeAudit::IsRedBlack(increasing));
+  ASSERT_LE(TreeAudit::Height(increasing), 2 * log_n);
+  ASSERT_TRUE(TreeAudit::IsAvl(decreasing));
+  ASSERT_EQ(increasing.Size(), n / 2);
+  ASSERT_TRUE(increasing.Find(n - 1));
+  ASSERT_FALSE(increasing.Find(n - 2));
+}
+
+TEST(RangeQueryTest, BoundsMatchStdMap) {
+  Map<int, int> map;
+  std::map<int, int> expected;
+  std::mt19937 mt(31);
+  for (int i = 0; i < 2000; ++i) {
+    int key = static_cast<int>(mt() % 10000);
+    map[key] = i;
+    expected[key] = i;
+  }
+  auto same = [&](Map<int, int>::MapIterator it, std::map<int, int>::iterator expected_it) {
+    if (expected_it == expected.end()) {
+      return it == map.End();
+    }
+    return it != map.End() && it->first == expected_it->first;
+  };
+  for (int key = -5; key < 10005; ++key) {
+    ASSERT_TRUE(same(map.LowerBound(key), expected.lower_bound(key)));
+    ASSERT_TRUE(same(map.UpperBound(key), expected.upper_bound(key)));
+    auto [first, last] = map.EqualRange(key);
+    ASSERT_EQ(std::distance(first, last), static_cast<std::ptrdiff_t>(expected.count(key)));
+  }
+  for (int i = 0; i < 200; ++i) {
+    int from = static_cast<int>(mt() % 10000);
+    int to = from + static_cast<int>(mt() % 500);
+    auto count = std::distance(expected.lower_bound(from), expected.lower_bound(to));
+    ASSERT_EQ(map.CountRange(from, to), static_cast<size_t>(count));
+  }
+  ASSERT_EQ(map.CountRange(100, 100), 0);
+  ASSERT_EQ(map.CountRange(200, 100), 0);
+}
+
+TEST(RangeQueryTest, WalkFromLowerBound) {
+  Map<std::string, int, std::less<>> map;
+  map.Insert({{"2024-01-01", 1}, {"2024-01-02", 2}, {"2024-02-01", 3}, {"2024-03-01", 4}});
+  std::vector<int> january;
+  for (auto it = map.LowerBound(std::string_view("2024-01")); it != map.LowerBound(std::string_view("2024-02")); ++it) {
+    january.push_back(it->second);
+  }
+  ASSERT_EQ(january, (std::vector<int>{1, 2}));
+  ASSERT_EQ(map.CountRange(std::string_view("2024-02"), std::string_view("2025")), 2);
+  ASSERT_EQ(map.UpperBound(std::string_view("2024-03-01")), map.End());
+
+  auto [first, last] = map.EqualRange(std::string_view("2024-02-01"));
+  ASSERT_EQ(first->second, 3);
+  ASSERT_EQ(last->second, 4);
+}
+
+template <typename Balance>
+void CheckOrderStatistics() {
+  using CountingMap = Map<int, int, std::less<int>, Balance, SubtreeSize>;
+  CountingMap map;
+  std::map<int, int> expected;
+  std::mt19937 mt(41);
+  auto check = [&](const CountingMap& tested) {
+    std::vector<int> keys;
+    for (const auto& entry : expected) {
+      keys.push_back(entry.first);
+    }
+    for (size_t k = 0; k < keys.size(); k += 7) {
+      ASSERT_EQ(tested.Select(k)->first, keys[k]);
+      ASSERT_EQ(tested.Rank(keys[k]), k);
+    }
+    ASSERT_EQ(tested.Select(keys.size()), tested.End());
+    for (int key = -1; key < 3001; key += 13) {
+      auto less = std::lower_bound(keys.begin(), keys.end(), key) - keys.begin();
+      ASSERT_EQ(tested.CountLess(key), static_cast<size_t>(less));
+      auto in_range = std::distance(expected.lower_bound(key), expected.lower_bound(key + 100));
+      ASSERT_EQ(tested.CountRange(key, key + 100), static_cast<size_t>(in_range));
+    }
+  };
+  for (int i = 0; i < 20000; ++i) {
+    int key = static_cast<int>(mt() % 3000);
+    if (mt() % 3 != 0) {
+      map[key] = i;
+      expected[key] = i;
+    } else if (expected.erase(key) != 0) {
+      map.Erase(key);
+    }
+    if (i % 2000 == 0) {
+      check(map);
+    }
+  }
+  check(map);
+  check(CountingMap(map));
+
+  std::vector<std::pair<int, int>> sorted(expected.begin(), expected.end());
+  check(CountingMap::BuildFromSorted(sorted.begin(), sorted.end()));
+  ASSERT_ANY_THROW(map.Rank(3001));
+}
+
+TEST(OrderStatisticsTest, RedBlack) {
+  CheckOrderStatistics<RedBlackBalance>();
+}
+
+TEST(OrderStatisticsTest, Avl) {
+  CheckOrderStatistics<AvlBalance>();
+}
+
+TEST(OrderStatisticsTest, Splay) {
+  CheckOrderStatistics<SplayBalance>();
+}
+
+TEST(EmplaceTest, TryEmplaceConstructsInPlace) {
+  Map<int, std::unique_ptr<std::string>> map;
+  auto [it, inserted] = map.TryEmplace(1, std::make_unique<std::string>("one"));
+  ASSERT_TRUE(inserted);
+  ASSERT_EQ(*it->second, "one");
+
+  auto value = std::make_unique<std::string>("uno");
+  auto [again, inserted_again] = map.TryEmplace(1, std::move(value));
+  ASSERT_FALSE(inserted_again);
+  ASSERT_EQ(again, it);
+  ASSERT_NE(value, nullptr);  // Not moved from when the key is present
+
+  Map<std::string, std::pair<int, int>> pairs;
+  std::string key = "key";
+  pairs.TryEmplace(std::move(key), 1, 2);
+  ASSERT_EQ(pairs["key"], (std::pair<int, int>{1, 2}));
+}
+
+TEST(EmplaceTest, InsertOrAssignAndEmplace) {
+  Map<std::string, int> map;
+  ASSERT_TRUE(map.InsertOrAssign("a", 1).second);
+  auto [it, inserted] = map.InsertOrAssign("a", 2);
+  ASSERT_FALSE(inserted);
+  ASSERT_EQ(it->second, 2);
+
+  ASSERT_TRUE(map.Emplace("b", 3).second);
+  auto [existing, emplaced] = map.Emplace(std::piecewise_construct, std::forward_as_tuple("b"), std::forward_as_tuple(4));
+  ASSERT_FALSE(emplaced);
+  ASSERT_EQ(existing->second, 3);
+  ASSERT_EQ(map.Size(), 2);
+}
+
+TEST(EmplaceTest, HintedInsert) {
+  Map<int, int> map;
+  for (int i = 0; i < 1000; ++i) {
+    auto [it, inserted] = map.Insert(map.End(), {i, i});
+    ASSERT_TRUE(inserted);
+    ASSERT_EQ(it->first, i);
+  }
+  auto last = map.End();
+  ASSERT_EQ((--last)->first, 999);
+  map.Erase(999);
+  last = map.End();
+  ASSERT_EQ((--last)->first, 998);
+
+  // Hints may be anywhere: wrong ones only cost a regular descent
+  std::map<int, int> expected(map.Ascending().begin(), map.Ascending().end());
+  std::mt19937 mt(3);
+  for (int i = 0; i < 5000; ++i) {
+    int key = static_cast<int>(mt() % 3000) - 1000;
+    auto hint = mt() % 2 == 0 ? map.LowerBound(key + static_cast<int>(mt() % 3)) : map.Begin();
+    auto [it, inserted] = map.Insert(hint, {key, i});
+    ASSERT_EQ(inserted, !expected.contains(key));
+    ASSERT_EQ(it->second, i);
+    expected[key] = i;
+  }
+  ASSERT_TRUE(std::equal(map.Ascending().begin(), map.Ascending().end(), expected.begin(), expected.end()));
+  ASSERT_EQ(map.Descending().begin()->first, expected.rbegin()->first);
+}
+
+// Orders people by id and lets them be looked up by the bare id
+struct Person {
+  int id;
+  std::string name;
+};
+
+struct ById {
+  using is_transparent = void;
+
+  bool operator()(const Person& lhs, const Person& rhs) const {
+    return lhs.id < rhs.id;
+  }
+  bool operator()(const Person& lhs, int rhs) const {
+    return lhs.id < rhs;
+  }
+  bool operator()(int lhs, const Person& rhs) const {
+    return lhs < rhs.id;
+  }
+};
+
+TEST(HeterogeneousLookupTest, StringView) {
+  Map<std::string, int, std::less<>> map;
+  map.Insert({{"alpha", 1}, {"beta", 2}, {"gamma", 3}});
+  std::string_view beta = "beta";
+  ASSERT_TRUE(map.Find(beta));
+  ASSERT_TRUE(map.Contains("gamma"));
+  ASSERT_FALSE(map.Contains(std::string_view("delta")));
+  ASSERT_TRUE(map.Find(std::string("alpha")));
+
+  map.Erase(beta);
+  ASSERT_FALSE(map.Contains(beta));
+  ASSERT_THROW(map.Erase(std::string_view("beta")), std::runtime_error);
+  ASSERT_EQ(map.Size(), 2);
+
+  // Without a transparent comparator the key is converted, as before
+  Map<std::string, int> plain;
+  plain["alpha"] = 1;
+  ASSERT_TRUE(plain.Find("alpha"));
+  ASSERT_TRUE(plain.Contains("alpha"));
+  plain.Erase("alpha");
+  ASSERT_TRUE(plain.IsEmpty());
+}
+
+TEST(HeterogeneousLookupTest, CustomTransparentComparator) {
+  Map<Person, double, ById> salaries;
+  salaries.Insert({Person{7, "Ann"}, 10.0});
+  salaries.Insert({Person{3, "Bob"}, 20.0});
+  ASSERT_TRUE(salaries.Contains(7));
+  ASSERT_FALSE(salaries.Contains(5));
+  salaries.Erase(3);
+  ASSERT_EQ(salaries.Size(), 1);
+  ASSERT_EQ(salaries.Values().front().first.name, "Ann");
+}
+
+template <typename MapType>
+void CheckBuildFromSorted(int count) {
+  std::vector<std::pair<int, int>> entries;
+  std::map<int, int> expected;
+  for (int i = 0; i < count; ++i) {
+    entries.emplace_back(3 * i, i);
+    expected[3 * i] = i;
+  }
+  MapType map = MapType::BuildFromSorted(entries.begin(), entries.end());
+  ASSERT_EQ(map.Size(), expected.size());
+  auto ascending = map.Ascending();
+  ASSERT_TRUE(std::equal(ascending.begin(), ascending.end(), expected.begin(), expected.end()));
+
+  // The built tree must stay valid under the balancing policy's updates
+  std::mt19937 mt(count);
+  for (int i = 0; i < 2 * count; ++i) {
+    int key = static_cast<int>(mt() % (3 * count + 3));
+    if (mt() % 2 == 0) {
+      map.Insert({key, i});
+      expected[key] = i;
+    } else if (expected.erase(key) != 0) {
+      map.Erase(key);
+    }
+  }
+  auto values = map.Values();
+  ASSERT_TRUE(std::equal(values.begin(), values.end(), expected.begin(), expected.end()));
+}
+
+TEST(BulkBuildTest, BuildFromSorted) {
+  for (int count : {0, 1, 2, 3, 7, 8, 100, 1023, 1024, 5000}) {
+    CheckBuildFromSorted<Map<int, int>>(count);
+    CheckBuildFromSorted<Map<int, int, std::less<int>, AvlBalance>>(count);
+  }
+}
+
+TEST(BulkBuildTest, DuplicatesAndOrder) {
+  std::vector<std::pair<int, std::string>> entries{{1, "a"}, {1, "b"}, {2, "c"}, {5, "d"}, {5, "e"}, {5, "f"}};
+  auto map = Map<int, std::string>::BuildFromSorted(entries.begin(), entries.end());
+  ASSERT_EQ(map.Size(), 3);
+  ASSERT_EQ(map[1], "b");
+  ASSERT_EQ(map[5], "f");
+
+  std::vector<std::pair<int, std::string>> unsorted{{2, "a"}, {1, "b"}};
+  using StringMap = Map<int, std::string>;
+  ASSERT_THROW(StringMap::BuildFromSorted(unsorted.begin(), unsorted.end()), std::runtime_error);
+
+  auto descending = Map<int, std::string, std::greater<int>>::BuildFromSorted(unsorted.begin(), unsorted.end());
+  ASSERT_EQ(descending.Values().front().first, 2);
+}
+
+TEST(BulkBuildTest, BuildFromUnsorted) {
+  std::vector<std::pair<std::string, int>> entries;
+  std::map<std::string, int> expected;
+  std::mt19937 mt(11);
+  for (int i = 0; i < 10000; ++i) {
+    std::string key = std::to_string(mt() % 3000);
+    entries.emplace_back(key, i);
+    expected[key] = i;
+  }
+  auto map = Map<std::string, int>::BuildFromUnsorted(entries.begin(), entries.end());
+  auto values = map.Values();
+  ASSERT_TRUE(std::equal(values.begin(), values.end(), expected.begin(), expected.end()));
+}
+
+TEST(MapViewTest, AscendingAndDescending) {
+  Map<int, std::string> map;
+  std::map<int, std::string> expected;
+  std::mt19937 mt(7);
+  for (int i = 0; i < 1000; ++i) {
+    int key = static_cast<int>(mt() % 5000);
+    map[key] = std::to_string(key);
+    expected[key] = std::to_string(key);
+  }
+  auto ascending = map.Ascending();
+  ASSERT_TRUE(std::equal(ascending.begin(), ascending.end(), expected.begin(), expected.end()));
+  auto descending = map.Descending();
+  ASSERT_TRUE(std::equal(descending.begin(), descending.end(), expected.rbegin(), expected.rend()));
+
+  // Views hand out references into the tree
+  for (auto& [key, value] : map.Ascending()) {
+    value += "!";
+  }
+  ASSERT_EQ(map.Values().front().second, expected.begin()->second + "!");
+
+  auto last = map.End();
+  --last;
+  ASSERT_EQ(last->first, expected.rbegin()->first);
+  ASSERT_ANY_THROW(*map.End());
+}
+
+TEST(MapViewTest, RangeBetweenKeys) {
+  Map<int, int> map;
+  for (int i = 0; i < 100; i += 2) {
+    map.Insert({i, i});
+  }
+  std::vector<int> keys;
+  for (const auto& [key, value] : map.Range(10, 21)) {
+    keys.push_back(key);
+  }
+  ASSERT_EQ(keys, (std::vector<int>{10, 12, 14, 16, 18, 20}));
+
+  keys.clear();
+  for (const auto& [key, value] : map.Range(-5, 3)) {
+    keys.push_back(key);
+  }
+  ASSERT_EQ(keys, (std::vector<int>{0, 2}));
+
+  ASSERT_TRUE(map.Range(11, 12).IsEmpty());
+  ASSERT_TRUE(map.Range(50, 50).IsEmpty());
+  ASSERT_TRUE(map.Range(60, 40).IsEmpty());
+  ASSERT_EQ(std::distance(map.Range(90, 1000).begin(), map.Range(90, 1000).end()), 5);
+
+  map.Clear();
+  ASSERT_TRUE(map.Descending().IsEmpty());
+}
+
+TEST(NodePoolTest, SharedPoolAcrossMaps) {
+  Map<int, std::string>::Pool pool;
+  Map<int, std::string> first(pool);
+  Map<int, std::string> second(pool);
+  for (int i = 0; i < 1000; ++i) {
+    first.Insert({i, std::to_string(i)});
+    second.Insert({-i, std::to_string(-i)});
+    if (i % 3 == 0) {
+      first.Erase(i);
+    }
+  }
+  Map<int, std::string> copy = second;
+  second.Clear();
+  ASSERT_TRUE(second.IsEmpty());
+  ASSERT_EQ(first.Size(), 666);
+  ASSERT_EQ(copy.Size(), 1000);
+  ASSERT_EQ(first[998], "998");
+  ASSERT_EQ(copy[-999], "-999");
+
+  // Slots freed by `second` are reused by the other maps
+  for (int i = 1000; i < 2000; ++i) {
+    copy.Insert({-i, std::to_string(-i)});
+  }
+  ASSERT_EQ(copy.Size(), 2000);
+}
+
+TEST(NodePoolTest, SwapOwnAndSharedPools) {
+  Map<int, int>::Pool pool;
+  Map<int, int> shared(pool);
+  Map<int, int> own;
+  for (int i = 0; i < 100; ++i) {
+    shared.Insert({i, 1});
+    own.Insert({i, 2});
+  }
+  own.Swap(shared);
+  own.Erase(0);
+  shared.Erase(0);
+  ASSERT_EQ(own[1], 1);
+  ASSERT_EQ(shared[1], 2);
+
+  own.Clear();
+  shared.Insert({1000, 3});
+  ASSERT_EQ(shared.Size(), 100);
+  ASSERT_EQ(shared.Values().back(), (std::pair<const int, int>{1000, 3}));
+}
+
+TEST(NodePoolTest, ReuseAfterClear) {
+  Map<std::string, std::string> map;
+  for (int round = 0; round < 3; ++round) {
+    for (int i = 0; i < 5000; ++i) {
+      map[std::to_string(i)] = std::string(40, 'a' + round);
+    }
+    ASSERT_EQ(map.Size(), 5000);
+    ASSERT_EQ(map["4999"], std::string(40, 'a' + round));
+    map.Clear();
+  }
+}
+
+TEST(FrozenMapTest, MatchesStdMap) {
+  std::mt19937 mt(31);
+  for (int size : {0, 1, 2, 3, 7, 8, 100, 1000, 4097}) {
+    std::map<int, int> expected;
+    while (static_cast<int>(expected.size()) < size) {
+      expected[static_cast<int>(mt() % 100000)] = static_cast<int>(mt());
+    }
+    auto frozen = FrozenMap<int, int>::BuildFromSorted(expected.begin(), expected.end());
+    ASSERT_EQ(frozen.Size(), expected.size());
+
+    for (int i = 0; i < 2000; ++i) {
+      int key = static_cast<int>(mt() % 100010) - 5;
+      ASSERT_EQ(frozen.Contains(key), expected.contains(key));
+      auto it = frozen.LowerBound(key);
+      auto expected_it = expected.lower_bound(key);
+      if (expected_it == expected.end()) {
+        ASSERT_EQ(it, frozen.End());
+      } else {
+        ASSERT_EQ(it->first, expected_it->first);
+        ASSERT_EQ(it->second, expected_it->second);
+      }
+    }
+
+    auto expected_it = expected.begin();
+    for (auto it = frozen.Begin(); it != frozen.End(); ++it, ++expected_it) {
+      ASSERT_EQ((*it).first, expected_it->first);
+    }
+    ASSERT_EQ(expected_it, expected.end());
+    auto back = frozen.End();
+    for (auto rit = expected.rbegin(); rit != expected.rend(); ++rit) {
+      ASSERT_EQ((--back)->first, rit->first);
+    }
+    ASSERT_EQ(back, frozen.Begin());
+  }
+}
+
+TEST(FrozenMapTest, BuildFromMap) {
+  Map<std::string, int, std::less<std::string>, AvlBalance> map;
+  map.Insert({{"b", 2}, {"a", 1}, {"c", 3}});
+  FrozenMap<std::string, int> frozen(map);
+  ASSERT_TRUE(frozen.Find("a"));
+  ASSERT_FALSE(frozen.Find("d"));
+  ASSERT_EQ(frozen.LowerBound("bb")->second, 3);
+  ASSERT_THROW(*frozen.LowerBound("d"), std::runtime_error);
+
+  using IntFrozenMap = FrozenMap<int, int>;
+  std::vector<std::pair<int, int>> unsorted{{2, 0}, {1, 0}};
+  ASSERT_THROW(IntFrozenMap::BuildFromSorted(unsorted.begin(), unsorted.end()), std::runtime_error);
+  std::vector<std::pair<int, int>> repeated{{1, 0}, {1, 5}};
+  auto last_wins = IntFrozenMap::BuildFromSorted(repeated.begin(), repeated.end());
+  ASSERT_EQ(last_wins.Size(), 1);
+  ASSERT_EQ(last_wins.LowerBound(1)->second, 5);
+}
+
+template <typename MapType>
+void CheckSplitJoin() {
+  std::mt19937 mt(12);
+  for (int round = 0; round < 50; ++round) {
+    MapType map;
+    std::map<int, int> expected;
+    int size = static_cast<int>(mt() % 2000);
+    for (int i = 0; i < size; ++i) {
+      int key = static_cast<int>(mt() % 5000);
+      map.Insert({key, i});
+      expected[key] = i;
+    }
+    int key = static_cast<int>(mt() % 5000);
+    MapType right = map.Split(key);
+    auto bound = expected.lower_bound(key);
+    ASSERT_EQ(map.Size(), std::distance(expected.begin(), bound));
+    ASSERT_EQ(right.Size(), std::distance(bound, expected.end()));
+    auto left_values = map.Values();
+    auto right_values = right.Values();
+    ASSERT_TRUE(std::equal(left_values.begin(), left_values.end(), expected.begin(), bound));
+    ASSERT_TRUE(std::equal(right_values.begin(), right_values.end(), bound, expected.end()));
+
+    MapType joined = MapType::Join(std::move(map), std::move(right));
+    auto values = joined.Values();
+    ASSERT_TRUE(std::equal(values.begin(), values.end(), expected.begin(), expected.end()));
+    joined.Insert({-1, 0});
+    ASSERT_EQ(joined.Size(), expected.size() + 1);
+  }
+}
+
+TEST(SetOperationsTest, SplitAndJoin) {
+  CheckSplitJoin<Map<int, int, std::less<int>, RedBlackBalance, SubtreeSize>>();
+  CheckSplitJoin<Map<int, int, std::less<int>, AvlBalance, SubtreeSize>>();
+  CheckSplitJoin<Map<int, int, std::less<int>, SplayBalance, SubtreeSize>>();
+
+  using IntMap = Map<int, int>;
+  IntMap left;
+  left.Insert({{1, 1}, {5, 5}});
+  IntMap right;
+  right.Insert({3, 3});
+  ASSERT_THROW(IntMap::Join(std::move(left), std::move(right)), std::runtime_error);
+}
+
+TEST(SetOperationsTest, MatchStdAlgorithms) {
+  std::mt19937 mt(21);
+  for (int round = 0; round < 50; ++round) {
+    std::map<int, int> lhs;
+    std::map<int, int> rhs;
+    for (int i = 0; i < static_cast<int>(mt() % 1000); ++i) {
+      lhs[static_cast<int>(mt() % 2000)] = i;
+    }
+    for (int i = 0; i < static_cast<int>(mt() % 100); ++i) {
+      rhs[static_cast<int>(mt() % 2000)] = -i;
+    }
+    auto make = [](const std::map<int, int>& entries) {
+      return Map<int, int>::BuildFromSorted(entries.begin(), entries.end());
+    };
+    auto key_less = [](const auto& a, const auto& b) { return a.first < b.first; };
+
+    // Of equal keys, std::set_union takes the first range's entry
+    std::vector<std::pair<const int, int>> united;
+    std::set_union(rhs.begin(), rhs.end(), lhs.begin(), lhs.end(), std::back_inserter(united), key_less);
+    auto map = make(lhs);
+    map.Union(make(rhs));
+    auto values = map.Values();
+    ASSERT_TRUE(std::equal(values.begin(), values.end(), united.begin(), united.end()));
+
+    std::vector<std::pair<const int, int>> common;
+    std::set_intersection(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::back_inserter(common), key_less);
+    map = make(lhs);
+    map.Intersection(make(rhs));
+    values = map.Values();
+    ASSERT_TRUE(std::equal(values.begin(), values.end(), common.begin(), common.end()));
+
+    std::vector<std::pair<const int, int>> difference;
+    std::set_difference(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::back_inserter(difference), key_less);
+    map = make(lhs);
+    auto other = make(rhs);
+    map.Difference(std::move(other));
+    values = map.Values();
+    ASSERT_TRUE(std::equal(values.begin(), values.end(), difference.begin(), difference.end()));
+    ASSERT_TRUE(other.IsEmpty());
+    ASSERT_EQ(map.Size(), difference.size());
+  }
+}
+
+TEST(SetOperationsTest, SharedPool) {
+  using SizedMap = Map<int, int, std::less<int>, RedBlackBalance, SubtreeSize>;
+  SizedMap::Pool pool;
+  SizedMap lhs(pool);
+  SizedMap rhs(pool);
+  for (int i = 0; i < 1000; ++i) {
+    lhs.Insert({i * 2, i});
+    rhs.Insert({i * 3, i});
+  }
+  lhs.Union(std::move(rhs));
+  ASSERT_EQ(lhs.Size(), 1000 + 1000 - 334);
+  auto tail = lhs.Split(1500);
+  ASSERT_EQ(tail.Values().front().first, 1500);
+  ASSERT_EQ(lhs.Values().back().first, 1498);
+
+  SizedMap own;
+  own.Insert({10000, 0});
+  ASSERT_THROW(lhs.Union(std::move(own)), std::runtime_error);
+}
+
+// Sorted inserts leave a splay tree a chain as deep as the map is large
+TEST(SetOperationsTest, SortedSplayMaps) {
+  using SplayMap = Map<int, int, std::less<int>, SplayBalance>;
+  const int size = 1 << 18;
+  SplayMap evens;
+  SplayMap thirds;
+  for (int i = 0; i < size; ++i) {
+    evens.Insert({i * 2, i});
+    thirds.Insert({i * 3, -i});
+  }
+  const int common = (size * 2 - 1) / 6 + 1;
+
+  SplayMap uni = evens;
+  uni.Union(SplayMap(thirds));
+  ASSERT_EQ(uni.Size(), size * 2 - common);
+  ASSERT_EQ(uni[6], -2);
+  ASSERT_EQ(uni[4], 2);
+  ASSERT_EQ(uni.Values().back().first, (size - 1) * 3);
+
+  SplayMap both = evens;
+  both.Intersection(SplayMap(thirds));
+  ASSERT_EQ(both.Size(), common);
+  ASSERT_EQ(both[6], 3);
+  ASSERT_FALSE(both.Contains(4));
+
+  evens.Difference(std::move(thirds));
+  ASSERT_EQ(evens.Size(), size - common);
+  ASSERT_TRUE(thirds.IsEmpty());
+  ASSERT_FALSE(evens.Contains(6));
+  ASSERT_EQ(evens[4], 2);
+  auto values = evens.Values();
+  ASSERT_TRUE(std::is_sorted(values.begin(), values.end()));
+}
+
+TEST(SetOperationsTest, SplitPartsOutliveEachOther) {
+  using IntMap = Map<int, std::string, std::less<int>, RedBlackBalance, SubtreeSize>;
+  auto head = std::make_unique<IntMap>();
+  IntMap other;
+  for (int i = 0; i < 3000; ++i) {
+    head->Insert({i, std::to_string(i)});
+    other.Insert({i * 2 + 10000, std::to_string(i)});
+  }
+  IntMap tail = head->Split(2000);
+  IntMap middle = head->Split(1000);
+  ASSERT_EQ(head->Size(), 1000);
+  ASSERT_EQ(middle.Size(), 1000);
+  ASSERT_EQ(tail.Size(), 1000);
+
+  // `other` takes over chunks that `middle` and `tail` still have nodes in
+  other.Union(std::move(*head));
+  head.reset();
+  ASSERT_EQ(other.Size(), 4000);
+  tail.Insert({5000, "5000"});
+  middle.Erase(1500);
+  tail = IntMap::Join(std::move(middle), std::move(tail));
+  ASSERT_EQ(tail.Size(), 2000);
+  ASSERT_EQ(tail.Values().back().second, "5000");
+
+  other.Clear();
+  other.Insert({0, "0"});
+  tail.Clear();
+  ASSERT_EQ(other.Values().front().second, "0");
+}
+
+// The parts of a split map on their own pools share nothing they write to
+TEST(SetOperationsTest, SplitPartsChangeInParallel) {
+  using SizedMap = Map<int, int, std::less<int>, RedBlackBalance, SubtreeSize>;
+  const int size = 100000;
+  SizedMap left;
+  for (int i = 0; i < size; ++i) {
+    left.Insert({i, i});
+  }
+  SizedMap right = left.Split(size / 2);
+  auto churn = [](SizedMap& map, int from) {
+    std::mt19937 mt(from);
+    for (int i = 0; i < 200000; ++i) {
+      int key = from + static_cast<int>(mt() % (size / 2));
+      if (mt() % 2 == 0) {
+        map.Erase(key);
+      }
+      map.Insert({key, i});
+    }
+  };
+  auto future = std::async(std::launch::async, churn, std::ref(right), size / 2);
+  churn(left, 0);
+  future.get();
+  ASSERT_EQ(left.Size(), size / 2);
+  ASSERT_EQ(right.Size(), size / 2);
+  left = SizedMap::Join(std::move(left), std::move(right));
+  ASSERT_EQ(left.Size(), size);
+  ASSERT_EQ(left.Select(size / 2)->first, size / 2);
+}
+
+TEST(PersistentMapTest, SnapshotsKeepTheirVersion) {
+  PersistentMap<int, int> map;
+  std::map<int, int> expected;
+  std::vector<std::pair<PersistentMap<int, int>, std::map<int, int>>> versions;
+  std::mt19937 mt(9);
+  for (int i = 0; i < 20000; ++i) {
+    int key = static_cast<int>(mt() % 3000);
+    switch (mt() % 3) {
+      case 0:
+        map.Insert({key, i});
+        expected[key] = i;
+        break;
+      case 1:
+        map[key] += 1;
+        expected[key] += 1;
+        break;
+      default:
+        if (expected.erase(key) != 0) {
+          map.Erase(key);
+        } else {
+          ASSERT_THROW(map.Erase(key), std::runtime_error);
+        }
+    }
+    if (i % 1000 == 0) {
+      versions.emplace_back(map.Snapshot(), expected);
+    }
+  }
+  versions.emplace_back(map, expected);
+  map.Clear();
+  ASSERT_TRUE(map.IsEmpty());
+
+  for (const auto& [snapshot, snapshot_expected] : versions) {
+    ASSERT_EQ(snapshot.Size(), snapshot_expected.size());
+    auto values = snapshot.Values();
+    ASSERT_TRUE(std::equal(values.begin(), values.end(), snapshot_expected.begin(), snapshot_expected.end()));
+    auto reversed = snapshot.Values(false);
+    ASSERT_TRUE(
+        std::equal(reversed.begin(), reversed.end(), snapshot_expected.rbegin(), snapshot_expected.rend()));
+  }
+}
+
+TEST(PersistentMapTest, UpdatesDoNotLeakIntoSnapshot) {
+  PersistentMap<std::string, int> map;
+  map.Insert({{"a", 1}, {"b", 2}, {"c", 3}});
+  auto snapshot = map.Snapshot();
+  map["b"] = 20;
+  map.Erase("a");
+  map.Insert({"d", 4});
+
+  ASSERT_TRUE(snapshot.Find("a"));
+  ASSERT_FALSE(snapshot.Find("d"));
+  ASSERT_EQ(snapshot.Values()[1].second, 2);
+  ASSERT_EQ(map.Values()[0].second, 20);
+
+  snapshot["a"] = 10;
+  ASSERT_FALSE(map.Find("a"));
+  std::swap(map, snapshot);
+  ASSERT_EQ(map.Size(), 3);
+  ASSERT_EQ(map.Values()[0].second, 10);
+}
+
+// The writer keeps releasing nodes that the exporting thread's snapshot still shares
+TEST(PersistentMapTest, ExportSnapshotWhileWriting) {
+  PersistentMap<int, int> map;
+  for (int i = 0; i < 10000; ++i) {
+    map.Insert({i, i});
+  }
+  auto snapshot = map.Snapshot();
+  auto exported = std::async(std::launch::async, [&snapshot] {
+    int64_t sum = 0;
+    for (int round = 0; round < 20; ++round) {
+      for (const auto& [key, value] : snapshot.Values()) {
+        sum += value - key;
+      }
+    }
+    return sum;
+  });
+  std::mt19937 mt(3);
+  for (int i = 0; i < 50000; ++i) {
+    int key = static_cast<int>(mt() % 10000);
+    if (map.Find(key)) {
+      map.Erase(key);
+    } else {
+      map.Insert({key, -1});
+    }
+  }
+  ASSERT_EQ(exported.get(), 0);
+  ASSERT_EQ(snapshot.Size(), 10000);
+}
+
+TEST(ConcurrentMapTest, SingleThreadMatchesStdMap) {
+  ConcurrentMap<int, std::string> map;
+  std::map<int, std::string> expected;
+  std::mt19937 mt(5);
+  for (int i = 0; i < 20000; ++i) {
+    int key = static_cast<int>(mt() % 2000);
+    if (mt() % 3 != 0) {
+      map.Insert({key, std::to_string(i)});
+      expected[key] = std::to_string(i);
+    } else if (expected.erase(key) != 0) {
+      map.Erase(key);
+    } else {
+      ASSERT_THROW(map.Erase(key), std::runtime_error);
+    }
+    ASSERT_EQ(map.Find(key), expected.contains(key));
+  }
+  ASSERT_EQ(map.Size(), expected.size());
+  ASSERT_EQ(map.Get(-1), std::nullopt);
+  ASSERT_EQ(*map.Get(expected.begin()->first), expected.begin()->second);
+  auto values = map.Values();
+  ASSERT_TRUE(std::equal(values.begin(), values.end(), expected.begin(), expected.end()));
+  auto reversed = map.Values(false);
+  ASSERT_TRUE(std::equal(reversed.begin(), reversed.end(), expected.rbegin(), expected.rend()));
+  map.Clear();
+  ASSERT_TRUE(map.IsEmpty());
+  ASSERT_TRUE(map.Values().empty());
+}
+
+TEST(ConcurrentMapTest, ParallelWritersAndReaders) {
+  constexpr int kWriters = 4;
+  constexpr int kKeysPerWriter = 5000;
+  ConcurrentMap<int, int64_t> map;
+  std::atomic<bool> stop{false};
+  std::atomic<int64_t> torn{0};
+
+  std::vector<std::thread> readers;
+  for (int r = 0; r < 2; ++r) {
+    readers.emplace_back([&, r] {
+      std::mt19937 mt(r);
+      while (!stop.load(std::memory_order_relaxed)) {
+        int key = static_cast<int>(mt() % (kWriters * kKeysPerWriter));
+        // Writers store key * 1000 + round, so any value read must belong to its key
+        if (auto value = map.Get(key); value && *value / 1000 != key) {
+          ++torn;
+        }
+      }
+    });
+  }
+  std::vector<std::thread> writers;
+  for (int w = 0; w < kWriters; ++w) {
+    writers.emplace_back([&, w] {
+      for (int round = 0; round < 3; ++round) {
+        for (int i = w; i < kWriters * kKeysPerWriter; i += kWriters) {
+          map.Insert({i, int64_t{i} * 1000 + round});
+        }
+        for (int i = w; i < kWriters * kKeysPerWriter; i += 2 * kWriters) {
+          map.Erase(i);
+        }
+      }
+    });
+  }
+  for (auto& writer : writers) {
+    writer.join();
+  }
+  stop = true;
+  for (auto& reader : readers) {
+    reader.join();
+  }
+
+  ASSERT_EQ(torn, 0);
+  ASSERT_EQ(map.Size(), kWriters * kKeysPerWriter / 2);
+  auto values = map.Values();
+  ASSERT_EQ(values.size(), map.Size());
+  for (size_t i = 0; i < values.size(); ++i) {
+    ASSERT_GE(values[i].first % (2 * kWriters), kWriters);
+    ASSERT_EQ(values[i].second, int64_t{values[i].first} * 1000 + 2);
+  }
+}
+
+// Several threads fight over the same few keys
+TEST(ConcurrentMapTest, ContendedKeys) {
+  ConcurrentMap<int, int> map;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&, t] {
+      std::mt19937 mt(t);
+      for (int i = 0; i < 20000; ++i) {
+        int key = static_cast<int>(mt() % 16);
+        if (mt() % 2 == 0) {
+          map.Insert({key, i});
+        } else {
+          try {
+            map.Erase(key);
+          } catch (const std::runtime_error&) {
+          }
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  auto values = map.Values();
+  ASSERT_EQ(values.size(), map.Size());
+  ASSERT_TRUE(std::is_sorted(values.begin(), values.end(),
+                             [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; }));
+  for (const auto& [key, value] : values) {
+    ASSERT_TRUE(map.Find(key));
+  }
+}
+
+template <typename Key>
+void CheckBTreeAgainstStdMap(int operations, int key_range, Key scale = 1) {
+  BTreeMap<Key, int> map;
+  std::map<Key, int> expected;
+  std::mt19937 mt(321);
+  std::uniform_int_distribution<int> keys(-key_range, key_range);
+  for (int i = 0; i < operations; ++i) {
+    Key key = static_cast<Key>(static_cast<Key>(keys(mt)) * scale);
+    switch (mt() % 4) {
+      case 0:
+      case 1:
+        map.Insert({key, i});
+        expected[key] = i;
+        break;
+      case 2:
+        map[key] += 1;
+        expected[key] += 1;
+        break;
+      default:
+        if (expected.erase(key) != 0) {
+          map.Erase(key);
+        } else {
+          ASSERT_ANY_THROW(map.Erase(key));
+        }
+    }
+    ASSERT_EQ(map.Find(key), expected.contains(key));
+    ASSERT_EQ(map.Contains(key), expected.contains(key));
+    auto bound = map.LowerBound(key);
+    auto expected_bound = expected.lower_bound(key);
+    if (expected_bound == expected.end()) {
+      ASSERT_EQ(bound, map.End());
+    } else {
+      ASSERT_NE(bound, map.End());
+      ASSERT_EQ(bound->first, expected_bound->first);
+    }
+  }
+  ASSERT_EQ(map.Size(), expected.size());
+  auto it = map.Begin();
+  for (const auto& [key, value] : expected) {
+    ASSERT_NE(it, map.End());
+    ASSERT_EQ(it->first, key);
+    ASSERT_EQ((*it).second, value);
+    ++it;
+  }
+  ASSERT_EQ(it, map.End());
+
+  auto values = map.Values(false);
+  ASSERT_TRUE(std::equal(values.begin(), values.end(), expected.rbegin(), expected.rend()));
+
+  for (const auto& [key, value] : expected) {
+    map.Erase(key);
+  }
+  ASSERT_TRUE(map.IsEmpty());
+  ASSERT_EQ(map.Begin(), map.End());
+}
+
+TEST(BTreeMapTest, MatchesStdMapSigned) {
+  CheckBTreeAgainstStdMap<int>(100000, 5000);
+}
+
+TEST(BTreeMapTest, MatchesStdMapUnsigned) {
+  CheckBTreeAgainstStdMap<uint32_t>(50000, 3000);
+}
+
+TEST(BTreeMapTest, MatchesStdMapWideKeys) {
+  CheckBTreeAgainstStdMap<int64_t>(50000, 3000);
+  // Keys that differ in both halves of the 64-bit word
+  CheckBTreeAgainstStdMap<int64_t>(50000, 3000, (int64_t{1} << 33) + 7);
+  CheckBTreeAgainstStdMap<uint64_t>(50000, 3000, (uint64_t{1} << 40) + 3);
+}
+
+TEST(BTreeMapTest, StringKeysAndCopy) {
+  BTreeMap<std::string, int> ages;
+  ages.Insert({
+    {"Maxim", 21},
+    {"Danya", 22},
+    {"Veronika", 24},
+    {"Anna", 19}
+  });
+  for (int i = 0; i < 500; ++i) {
+    ages[fmt::format("user{:04}", i)] = i;
+  }
+  BTreeMap<std::string, int> copy = ages;
+  ages.Clear();
+  ASSERT_EQ(copy.Size(), 504);
+  ASSERT_EQ(copy.Begin()->first, "Anna");
+  ASSERT_EQ((--copy.End())->first, "user0499");
+  ASSERT_TRUE(copy.Find("Veronika"));
+  ASSERT_EQ(copy.LowerBound("Veronika")->second, 24);
+  ASSERT_FALSE(copy.Find("Nobody"));
+  ASSERT_EQ(copy.LowerBound("Nobody")->first, "Veronika");
+  ASSERT_EQ(copy.LowerBound("zzz"), copy.End());
+}
+
+TEST(BTreeMapTest, SwapAndReverseIteration) {
+  BTreeMap<int, int> a;
+  BTreeMap<int, int> b;
+  for (int i = 0; i < 1000; ++i) {
+    a[i] = -i;
+  }
+  b[7] = 7;
+  std::swap(a, b);
+  ASSERT_EQ(a.Size(), 1);
+  ASSERT_EQ(b.Size(), 1000);
+  int expected = 999;
+  for (auto it = b.End(); it != b.Begin();) {
+    --it;
+    ASSERT_EQ(it->first, expected--);
+  }
+  ASSERT_EQ(expected, -1);
+}
+
+TEST(HashMapTest, MatchesStdMap) {
+  HashMap<int, int> map;
+  std::map<int, int> expected;
+  std::mt19937 mt(654);
+  std::uniform_int_distribution<int> keys(-3000, 3000);
+  for (int i = 0; i < 200000; ++i) {
+    int key = keys(mt);
+    switch (mt() % 4) {
+      case 0:
+        map.Insert({key, i});
+        expected[key] = i;
+        break;
+      case 1:
+        map[key] += 1;
+        expected[key] += 1;
+        break;
+      default:
+        // Erase as often as insert, so that the table fills with tombstones
+        if (expected.erase(key) != 0) {
+          map.Erase(key);
+        } else {
+          ASSERT_THROW(map.Erase(key), std::runtime_error);
+        }
+    }
+    ASSERT_EQ(map.Find(key), expected.contains(key));
+  }
+  ASSERT_EQ(map.Size(), expected.size());
+  auto values = map.Values();
+  std::map<int, int> actual(values.begin(), values.end());
+  ASSERT_EQ(actual, expected);
+  for (const auto& [key, value] : expected) {
+    ASSERT_EQ(map[key], value);
+  }
+  ASSERT_EQ(map.Size(), expected.size());
+}
+
+TEST(HashMapTest, ReserveCopyAndClear) {
+  HashMap<std::string, int> ages;
+  ASSERT_FALSE(ages.Find("Nobody"));
+  ASSERT_THROW(ages.Erase("Nobody"), std::runtime_error);
+  ages.Reserve(1000);
+  size_t capacity = ages.Capacity();
+  ASSERT_GE(capacity, 1000);
+  ages.Insert({
+    {"Maxim", 21},
+    {"Danya", 22},
+    {"Veronika", 24},
+    {"Anna", 19}
+  });
+  for (int i = 0; i < 996; ++i) {
+    ages[fmt::format("user{:04}", i)] = i;
+  }
+  ASSERT_EQ(ages.Capacity(), capacity);
+
+  HashMap<std::string, int> copy = ages;
+  ages.Clear();
+  ASSERT_TRUE(ages.IsEmpty());
+  ASSERT_FALSE(ages.Contains("Anna"));
+  ASSERT_EQ(ages.Capacity(), capacity);
+  ASSERT_EQ(copy.Size(), 1000);
+  ASSERT_EQ(copy["Veronika"], 24);
+  ASSERT_EQ(copy["user0995"], 995);
+
+  HashMap<std::string, int> other;
+  other["Anna"] = 20;
+  std::swap(copy, other);
+  ASSERT_EQ(copy.Size(), 1);
+  ASSERT_EQ(copy["Anna"], 20);
+  ASSERT_EQ(other.Size(), 1000);
+  other = std::move(copy);
+  ASSERT_EQ(other.Size(), 1);
+}
+
+TEST(IntervalMapTest, MatchesBruteForce) {
+  IntervalMap<int, int> map;
+  std::map<std::pair<int, int>, int> expected;
+  std::mt19937 mt(1848);
+  std::uniform_int_distribution<int> starts(0, 10000);
+  std::uniform_int_distribution<int> lengths(0, 300);
+  auto overlaps = [&expected](int low, int high) {
+    std::vector<std::pair<Interval<int>, int>> result;
+    for (const auto& [interval, value] : expected) {
+      if (interval.first <= high && low <= interval.second) {
+        result.push_back({{interval.first, interval.second}, value});
+      }
+    }
+    return result;
+  };
+  auto as_vector = [](const auto& entries) {
+    return std::vector<std::pair<Interval<int>, int>>(entries.begin(), entries.end());
+  };
+  for (int i = 0; i < 20000; ++i) {
+    int low = starts(mt);
+    int high = low + lengths(mt);
+    switch (mt() % 5) {
+      case 0:
+      case 1:
+        map.Insert({{low, high}, i});
+        expected[{low, high}] = i;
+        break;
+      case 2:
+        // Intervals sharing the start of an existing one
+        if (!expected.empty()) {
+          int shared = std::prev(expected.end())->first.first;
+          int end = shared + lengths(mt);
+          map[{shared, end}] = i;
+          expected[{shared, end}] = i;
+        }
+        break;
+      case 3:
+        if (expected.erase({low, high}) != 0) {
+          map.Erase({low, high});
+        } else {
+          ASSERT_THROW(map.Erase({low, high}), std::runtime_error);
+        }
+        if (!expected.empty() && mt() % 2 == 0) {
+          auto [first, second] = expected.begin()->first;
+          expected.erase(expected.begin());
+          map.Erase({first, second});
+        }
+        break;
+      default:
+        ASSERT_EQ(as_vector(map.Overlaps(low, high)), overlaps(low, high));
+        ASSERT_EQ(as_vector(map.Stab(low)), overlaps(low, low));
+    }
+  }
+  ASSERT_EQ(map.Size(), expected.size());
+  ASSERT_EQ(as_vector(map.Overlaps(-1, 20000)), overlaps(-1, 20000));
+}
+
+TEST(IntervalMapTest, ClosedEndsAndErrors) {
+  IntervalMap<int, std::string> meetings{
+    {{9, 10}, "standup"},
+    {{10, 12}, "review"},
+    {{13, 13}, "call"},
+    {{1, 20}, "workday"}
+  };
+  auto names = [](const auto& entries) {
+    std::vector<std::string> result;
+    for (const auto& [interval, name] : entries) {
+      result.push_back(name);
+    }
+    return result;
+  };
+  ASSERT_EQ(names(meetings.Stab(10)), (std::vector<std::string>{"workday", "standup", "review"}));
+  ASSERT_EQ(names(meetings.Stab(13)), (std::vector<std::string>{"workday", "call"}));
+  ASSERT_EQ(names(meetings.Overlaps(12, 13)), (std::vector<std::string>{"workday", "review", "call"}));
+  ASSERT_TRUE(meetings.Overlaps(21, 30).empty());
+  ASSERT_TRUE(meetings.Overlaps(12, 9).empty());
+  ASSERT_THROW(meetings.Insert({{5, 4}, "backwards"}), std::runtime_error);
+  ASSERT_THROW((meetings[{5, 4}]), std::runtime_error);
+  ASSERT_THROW(meetings.Erase({9, 11}), std::runtime_error);
+
+  size_t visited = 0;
+  meetings.ForEachOverlap(0, 100, [&visited](const auto&) { ++visited; });
+  ASSERT_EQ(visited, 4);
+
+  meetings.Erase({1, 20});
+  ASSERT_FALSE(meetings.Contains({1, 20}));
+  ASSERT_EQ(names(meetings.Stab(11)), (std::vector<std::string>{"review"}));
+
+  IntervalMap<int, std::string> other;
+  other[{0, 0}] = "midnight";
+  std::swap(meetings, other);
+  ASSERT_EQ(meetings.Size(), 1);
+  ASSERT_EQ(other.Size(), 3);
+  ASSERT_EQ(names(meetings.Stab(0)), (std::vector<std::string>{"midnight"}));
+  other.Clear();
+  ASSERT_TRUE(other.IsEmpty());
+  ASSERT_TRUE(other.Stab(10).empty());
+}
 
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
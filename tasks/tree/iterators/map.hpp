@@ -4,133 +4,426 @@
 
 #include <cstdlib>
 #include <functional>
+#include <initializer_list>
 #include <iterator>
+#include <stdexcept>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
+// Ordered dictionary on a threaded binary search tree. An empty child link is not null but a
+// thread: an empty left link points to the in-order predecessor, an empty right link to the
+// successor. Iterators step along the threads without parent pointers or a stack, so ++ and --
+// are O(1) amortized and a full walk in either direction is O(n).
+//
+// The header node holds no entry. The root is its left child, and the threads off both ends of
+// the order point back to it, so it is End() for either direction.
 template <typename Key, typename Value, typename Compare = std::less<Key>>
 class Map {
+    struct Link;
+    struct Node;
 
-    class Node;
-
-public:
-    class MapIterator {
+    // Walks in key order if `kAscending`, in reverse key order otherwise
+    template <bool kAscending>
+    class BasicIterator {
     public:
         // NOLINTNEXTLINE
         using value_type = std::pair<const Key, Value>;
         // NOLINTNEXTLINE
-        using reference_type = value_type&;
+        using reference = value_type&;
         // NOLINTNEXTLINE
-        using pointer_type = value_type*;
+        using pointer = value_type*;
         // NOLINTNEXTLINE
         using difference_type = std::ptrdiff_t;
         // NOLINTNEXTLINE
-        using iterator_category = std::forward_iterator_tag;
+        using iterator_category = std::bidirectional_iterator_tag;
 
-        inline bool operator==(const MapIterator&) const {
-            std::abort();  // Not implemented
-        };
+        BasicIterator() = default;
 
-        inline bool operator!=(const MapIterator&) const {
-            std::abort();  // Not implemented
-        };
+        inline bool operator==(const BasicIterator& other) const {
+            return current_ == other.current_;
+        }
+
+        inline bool operator!=(const BasicIterator& other) const {
+            return current_ != other.current_;
+        }
 
-        inline reference_type operator*() const {
-            std::abort();  // Not implemented
-        };
+        inline reference operator*() const {
+            if (current_->is_header) {
+                throw std::runtime_error("Dereferencing end iterator");
+            }
+            return static_cast<Node*>(current_)->value;
+        }
 
-        MapIterator& operator++() {
-            std::abort();  // Not implemented
-        };
+        inline pointer operator->() const {
+            return &**this;
+        }
 
-        MapIterator operator++(int) {
-            std::abort();  // Not implemented
-        };
+        // Stays at the end
+        BasicIterator& operator++() {
+            if (!current_->is_header) {
+                current_ = kAscending ? Next(current_) : Prev(current_);
+            }
+            return *this;
+        }
 
-        inline pointer_type operator->() const {
-            std::abort();  // Not implemented
-        };
+        BasicIterator operator++(int) {
+            BasicIterator tmp = *this;
+            ++(*this);
+            return tmp;
+        }
 
-    private:
-        explicit MapIterator(const Node*) {
-            // Not implemented
+        // Stepping back from the end lands on the last entry in iteration order
+        BasicIterator& operator--() {
+            current_ = kAscending ? Prev(current_) : Next(current_);
+            return *this;
+        }
+
+        BasicIterator operator--(int) {
+            BasicIterator tmp = *this;
+            --(*this);
+            return tmp;
         }
 
     private:
-        Node* current_;
+        explicit BasicIterator(Link* current) : current_(current) {
+        }
+
+        Link* current_{nullptr};
+
+        friend class Map;
     };
 
+public:
+    using MapIterator = BasicIterator<true>;
+    using ReverseMapIterator = BasicIterator<false>;
+
+    // O(h): the leftmost entry
     inline MapIterator Begin() const noexcept {
-        std::abort();  // Not implemented
+        return MapIterator(Next(Header()));
     }
 
     inline MapIterator End() const noexcept {
-        std::abort();  // Not implemented
+        return MapIterator(Header());
+    }
+
+    // O(h): the rightmost entry
+    inline ReverseMapIterator RBegin() const noexcept {
+        return ReverseMapIterator(Prev(Header()));
+    }
+
+    inline ReverseMapIterator REnd() const noexcept {
+        return ReverseMapIterator(Header());
     }
 
     Map() {
-        // Not implemented
+        header_.left = &header_;
+        header_.right = &header_;
+        header_.is_header = true;
+    }
+
+    // O(n): the copy keeps the shape of `other`, its threads point into the new header
+    Map(const Map& other) : Map() {
+        comp = other.comp;
+        CopyFrom(other);
     }
 
-    Value& operator[](const Key& /*key*/) {
-        std::abort();  // Not implemented
+    // Builds the copy aside, so a failure leaves this map as it was
+    Map& operator=(const Map& other) {
+        if (this != &other) {
+            Map copy(other);
+            Swap(copy);
+        }
+        return *this;
+    }
+
+    Map(Map&& other) noexcept : Map() {
+        Swap(other);
+    }
+
+    Map& operator=(Map&& other) noexcept {
+        if (this != &other) {
+            Clear();
+            Swap(other);
+        }
+        return *this;
+    }
+
+    Value& operator[](const Key& key) {
+        auto [parent, is_left] = FindParent(key);
+        if (!(is_left ? parent->left_is_thread : parent->right_is_thread)) {
+            return static_cast<Node*>(is_left ? parent->left : parent->right)->value.second;
+        }
+        return Attach(new Node(key, Value()), parent, is_left)->value.second;
     }
 
     inline bool IsEmpty() const noexcept {
-        std::abort();  // Not implemented
+        return size_ == 0;
     }
 
     inline size_t Size() const noexcept {
-        std::abort();  // Not implemented
+        return size_;
     }
 
     void Swap(Map& a) {
         static_assert(std::is_same<decltype(this->comp), decltype(a.comp)>::value,
                       "The compare function types are different");
-        // Not implemented
+        std::swap(header_, a.header_);
+        std::swap(size_, a.size_);
+        std::swap(comp, a.comp);
+        // The links into each header moved with the trees: point them at the new headers
+        Rethread();
+        a.Rethread();
     }
 
-    std::vector<std::pair<const Key, Value>> Values(bool /*is_increase=true*/) const noexcept {
-        std::abort();  // Not implemented
+    std::vector<std::pair<const Key, Value>> Values(bool is_increase = true) const noexcept {
+        std::vector<std::pair<const Key, Value>> values;
+        values.reserve(size_);
+        if (is_increase) {
+            for (auto it = Begin(); it != End(); ++it) {
+                values.push_back(*it);
+            }
+        } else {
+            for (auto it = RBegin(); it != REnd(); ++it) {
+                values.push_back(*it);
+            }
+        }
+        return values;
     }
 
-    void Insert(const std::pair<const Key, Value>& /*val*/) {
-        // Not implemented
+    // Overwrites the value if the key is already present
+    void Insert(const std::pair<const Key, Value>& val) {
+        (*this)[val.first] = val.second;
     }
 
-    void Insert(const std::initializer_list<std::pair<const Key, Value>>& /*values*/) {
-        // Not implemented
+    void Insert(const std::initializer_list<std::pair<const Key, Value>>& values) {
+        for (const auto& val : values) {
+            Insert(val);
+        }
     }
 
-    void Erase(const Key& /*key*/) {
-        // Not implemented
+    void Erase(const Key& key) {
+        auto [parent, is_left] = FindParent(key);
+        if (is_left ? parent->left_is_thread : parent->right_is_thread) {
+            throw std::runtime_error("Value not found");
+        }
+        Node* node = static_cast<Node*>(is_left ? parent->left : parent->right);
+        Link* replacement = nullptr;
+        if (node->left_is_thread && node->right_is_thread) {
+            // A leaf: the parent's link turns into the thread the leaf had on that side
+            replacement = is_left ? node->left : node->right;
+        } else if (node->right_is_thread) {
+            // Only a left subtree: its last entry now precedes the node's successor
+            Rightmost(node->left)->right = node->right;
+            replacement = node->left;
+        } else if (node->left_is_thread) {
+            Leftmost(node->right)->left = node->left;
+            replacement = node->right;
+        } else {
+            // Two subtrees: the successor moves into the node's place (keys are const, so the
+            // node is relinked rather than overwritten)
+            Link* successor_parent = node;
+            Link* successor = node->right;
+            while (!successor->left_is_thread) {
+                successor_parent = successor;
+                successor = successor->left;
+            }
+            if (successor_parent != node) {
+                if (successor->right_is_thread) {
+                    // successor_parent's predecessor is now the successor itself, in its new place
+                    successor_parent->left = successor;
+                    successor_parent->left_is_thread = true;
+                } else {
+                    successor_parent->left = successor->right;
+                }
+                successor->right = node->right;
+                successor->right_is_thread = false;
+            }
+            Rightmost(node->left)->right = successor;
+            successor->left = node->left;
+            successor->left_is_thread = false;
+            replacement = successor;
+        }
+        bool becomes_thread = node->left_is_thread && node->right_is_thread;
+        if (is_left) {
+            parent->left = replacement;
+            parent->left_is_thread = becomes_thread;
+        } else {
+            parent->right = replacement;
+            parent->right_is_thread = becomes_thread;
+        }
+        delete node;
+        --size_;
     }
 
+    // Deletes in key order: a forward walk never follows a link back to an entry it has passed
     void Clear() noexcept {
-        // Not implemented
+        Link* link = Next(&header_);
+        while (!link->is_header) {
+            Link* next = Next(link);
+            delete static_cast<Node*>(link);
+            link = next;
+        }
+        header_.left = &header_;
+        header_.left_is_thread = true;
+        size_ = 0;
     }
 
-    MapIterator Find(const Key& /*key*/) const {
-        std::abort();  // Not implemented
+    MapIterator Find(const Key& key) const {
+        auto [parent, is_left] = FindParent(key);
+        if (is_left ? parent->left_is_thread : parent->right_is_thread) {
+            return End();
+        }
+        return MapIterator(is_left ? parent->left : parent->right);
     }
 
     ~Map() {
-        // Not implemented
+        Clear();
     }
 
 private:
-    class Node {
-        friend class MapIterator;
-        friend class Map;
+    // Child links of a node, or of the header. A link marked as a thread points to the in-order
+    // neighbour on that side instead of a child.
+    struct Link {
+        Link* left{nullptr};
+        Link* right{nullptr};
+        bool left_is_thread{true};
+        // The header's right link is a child link to itself
+        bool right_is_thread{false};
+        bool is_header{false};
+    };
 
-    private:
-        /*???*/
+    struct Node : Link {
+        std::pair<const Key, Value> value;
+
+        Node(const Key& key, Value&& val) : value(key, std::move(val)) {
+        }
+
+        explicit Node(const std::pair<const Key, Value>& val) : value(val) {
+        }
     };
-    /*???*/
+
+    // Walks the threads: the next entry is either the thread target or the leftmost entry of the
+    // right subtree. The header's right link is its own child, so the entry after it is the first.
+    static Link* Next(Link* link) noexcept {
+        if (link->right_is_thread) {
+            return link->right;
+        }
+        return Leftmost(link->right);
+    }
+
+    static Link* Prev(Link* link) noexcept {
+        if (link->left_is_thread) {
+            return link->left;
+        }
+        return Rightmost(link->left);
+    }
+
+    static Link* Leftmost(Link* link) noexcept {
+        while (!link->left_is_thread) {
+            link = link->left;
+        }
+        return link;
+    }
+
+    static Link* Rightmost(Link* link) noexcept {
+        while (!link->right_is_thread) {
+            link = link->right;
+        }
+        return link;
+    }
+
+    Link* Header() const noexcept {
+        return const_cast<Link*>(static_cast<const Link*>(&header_));
+    }
+
+    // The link slot where `key` is or would be attached: the parent and the side. The root hangs
+    // on the left of the header.
+    std::pair<Link*, bool> FindParent(const Key& key) const {
+        Link* parent = Header();
+        bool is_left = true;
+        while (!(is_left ? parent->left_is_thread : parent->right_is_thread)) {
+            Node* node = static_cast<Node*>(is_left ? parent->left : parent->right);
+            if (comp(key, node->value.first)) {
+                is_left = true;
+            } else if (comp(node->value.first, key)) {
+                is_left = false;
+            } else {
+                break;
+            }
+            parent = node;
+        }
+        return {parent, is_left};
+    }
+
+    // Hangs a new leaf in the empty slot on the `is_left` side of `parent`. The leaf inherits the
+    // thread that was there and threads back to the parent on the other side.
+    Node* Attach(Node* node, Link* parent, bool is_left) noexcept {
+        if (is_left) {
+            node->left = parent->left;
+            node->right = parent;
+            parent->left = node;
+            parent->left_is_thread = false;
+        } else {
+            node->right = parent->right;
+            node->left = parent;
+            parent->right = node;
+            parent->right_is_thread = false;
+        }
+        node->left_is_thread = true;
+        node->right_is_thread = true;
+        ++size_;
+        return node;
+    }
+
+    // Walks `other` in key order in step with this empty map, without a stack. Each entry is
+    // attached below the copy of its parent before any entry of its subtrees, so Attach leaves
+    // every thread pointing at the copy of its target, and the walk climbs the threads of both
+    // trees together.
+    void CopyFrom(const Map& other) {
+        if (other.IsEmpty()) {
+            return;
+        }
+        Link* from = other.Header();
+        Link* to = &header_;
+        bool is_left = true;
+        while (true) {
+            // Copies the child in the slot, then its path down to the leftmost entry
+            while (!(is_left ? from->left_is_thread : from->right_is_thread)) {
+                Node* child = static_cast<Node*>(is_left ? from->left : from->right);
+                to = Attach(new Node(child->value), to, is_left);
+                from = child;
+                is_left = true;
+            }
+            // Up to the next entry with a right subtree left to copy
+            while (from->right_is_thread) {
+                from = from->right;
+                to = to->right;
+                if (from->is_header) {
+                    return;
+                }
+            }
+            is_left = false;
+        }
+    }
+
+    // After the header's links were swapped in: the two end threads and the header's own right
+    // link still point at the old header
+    void Rethread() noexcept {
+        header_.right = &header_;
+        if (header_.left_is_thread) {
+            header_.left = &header_;
+            return;
+        }
+        Leftmost(header_.left)->left = &header_;
+        Rightmost(header_.left)->right = &header_;
+    }
+
+    Link header_;
+    size_t size_{0};
 
 private:
     Compare comp;
-    /*???*/
 };
 
 namespace std {
@@ -139,4 +432,4 @@ template <typename Key, typename Value>
 void swap(Map<Key, Value>& a, Map<Key, Value>& b) {
     a.Swap(b);
 }
-}  // namespace std
\ No newline at end of file
+}  // namespace std
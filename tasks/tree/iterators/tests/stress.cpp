@@ -132,6 +132,63 @@ void BM_StdMapClear(benchmark::State& state) {
   state.SetComplexityN(state.range(0));
 }
 
+// Full walks over a random tree built outside the timing; each visits every entry once
+void BM_CustomMapIterate(benchmark::State& state) {
+  Map<int, int> mp;
+  ConstructRandomMap(mp, state.range(0));
+  for (auto _ : state) {
+    int64_t sum = 0;
+    for (auto it = mp.Begin(); it != mp.End(); ++it) {
+      sum += it->second;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * mp.Size());
+  state.SetComplexityN(state.range(0));
+}
+
+void BM_StdMapIterate(benchmark::State& state) {
+  std::map<int, int> mp;
+  ConstructRandomMap(mp, state.range(0));
+  for (auto _ : state) {
+    int64_t sum = 0;
+    for (auto it = mp.begin(); it != mp.end(); ++it) {
+      sum += it->second;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * mp.size());
+  state.SetComplexityN(state.range(0));
+}
+
+void BM_CustomMapReverseIterate(benchmark::State& state) {
+  Map<int, int> mp;
+  ConstructRandomMap(mp, state.range(0));
+  for (auto _ : state) {
+    int64_t sum = 0;
+    for (auto it = mp.RBegin(); it != mp.REnd(); ++it) {
+      sum += it->second;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * mp.Size());
+  state.SetComplexityN(state.range(0));
+}
+
+void BM_StdMapReverseIterate(benchmark::State& state) {
+  std::map<int, int> mp;
+  ConstructRandomMap(mp, state.range(0));
+  for (auto _ : state) {
+    int64_t sum = 0;
+    for (auto it = mp.rbegin(); it != mp.rend(); ++it) {
+      sum += it->second;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * mp.size());
+  state.SetComplexityN(state.range(0));
+}
+
 
 BENCHMARK(BM_CustomMapRandomInsert)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
 BENCHMARK(BM_StdMapRandomInsert)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
@@ -141,5 +198,9 @@ BENCHMARK(BM_CustomMapErase)->Range(1<<10, 1<<17)->Complexity()->Unit(benchmark:
 BENCHMARK(BM_StdMapErase)->Range(1<<10, 1<<17)->Complexity()->Unit(benchmark::kMillisecond);
 BENCHMARK(BM_CustomMapClear)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
 BENCHMARK(BM_StdMapClear)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CustomMapIterate)->Range(1<<10, 1<<20)->Complexity(benchmark::oN);
+BENCHMARK(BM_StdMapIterate)->Range(1<<10, 1<<20)->Complexity(benchmark::oN);
+BENCHMARK(BM_CustomMapReverseIterate)->Range(1<<10, 1<<20)->Complexity(benchmark::oN);
+BENCHMARK(BM_StdMapReverseIterate)->Range(1<<10, 1<<20)->Complexity(benchmark::oN);
 
 BENCHMARK_MAIN();
\ No newline at end of file
@@ -1,6 +1,8 @@
 #include <chrono>
 #include <future>
+#include <iterator>
 #include <map>
+#include <random>
 #include <iostream>
 #include <string>
 #include <thread>
@@ -235,6 +237,29 @@ TEST_F(MapTest, SimpleIteratorBypass) {
   }
 }
 
+TEST_F(MapTest, ReverseIteratorBypass) {
+  auto values = mp.Values(false);
+  auto it = mp.RBegin();
+
+  for (size_t i = 0; i < values.size(); ++i, it++) {
+    ASSERT_EQ(*it, values[i]);
+  }
+  ASSERT_EQ(it, mp.REnd());
+}
+
+TEST_F(MapTest, DecrementFromEnd) {
+  auto values = mp.Values(true);
+  auto it = mp.End();
+
+  for (size_t i = values.size(); i > 0; --i) {
+    --it;
+    ASSERT_EQ(*it, values[i - 1]);
+  }
+  ASSERT_EQ(it, mp.Begin());
+  ASSERT_EQ(std::prev(mp.REnd())->first, -10);
+  ASSERT_THROW(*mp.End(), std::runtime_error);
+}
+
 TEST_F(MapTest, Clear) {
   mp.Clear();
   ASSERT_TRUE(mp.IsEmpty());
@@ -372,6 +397,119 @@ TEST_F(MapTest, CustomComparator) {
 }
 
 
+// Threads must stay consistent through inserts and erases of every shape of node
+TEST(ThreadedMapTest, IterationMatchesStdMap) {
+  Map<int, int> map;
+  std::map<int, int> expected;
+  std::mt19937 mt(7);
+  std::uniform_int_distribution<int> keys(0, 500);
+  for (int i = 0; i < 20000; ++i) {
+    int key = keys(mt);
+    if (mt() % 2 == 0) {
+      map[key] = i;
+      expected[key] = i;
+    } else if (expected.erase(key) != 0) {
+      map.Erase(key);
+    } else {
+      ASSERT_ANY_THROW(map.Erase(key));
+    }
+    if (i % 100 != 0) {
+      continue;
+    }
+    ASSERT_EQ(map.Size(), expected.size());
+    auto it = map.Begin();
+    for (const auto& entry : expected) {
+      ASSERT_EQ(*it, entry);
+      ++it;
+    }
+    ASSERT_EQ(it, map.End());
+    auto rit = map.RBegin();
+    for (auto std_it = expected.rbegin(); std_it != expected.rend(); ++std_it) {
+      ASSERT_EQ(*rit, *std_it);
+      ++rit;
+    }
+    ASSERT_EQ(rit, map.REnd());
+    auto found = map.Find(key);
+    if (expected.contains(key)) {
+      ASSERT_EQ(found->first, key);
+      auto next = std::next(expected.find(key));
+      ASSERT_EQ(std::next(found), next == expected.end() ? map.End() : map.Find(next->first));
+    } else {
+      ASSERT_EQ(found, map.End());
+    }
+  }
+}
+
+TEST(ThreadedMapTest, SwapAndMoveKeepEnds) {
+  Map<int, int> a;
+  Map<int, int> b;
+  for (int i = 0; i < 100; ++i) {
+    a[i] = i;
+  }
+  b[-1] = -1;
+  std::swap(a, b);
+  ASSERT_EQ(std::prev(a.End())->first, -1);
+  ASSERT_EQ(std::next(a.Begin()), a.End());
+  ASSERT_EQ(std::prev(b.End())->first, 99);
+  ASSERT_EQ(b.RBegin()->first, 99);
+
+  Map<int, int> moved(std::move(b));
+  ASSERT_TRUE(b.IsEmpty());
+  ASSERT_EQ(b.Begin(), b.End());
+  ASSERT_EQ(std::distance(moved.Begin(), moved.End()), 100);
+  ASSERT_EQ(std::prev(moved.End())->first, 99);
+  moved.Clear();
+  ASSERT_EQ(moved.Begin(), moved.End());
+  ASSERT_EQ(moved.RBegin(), moved.REnd());
+}
+
+TEST(ThreadedMapTest, CopiesAreIndependent) {
+  Map<int, std::string> map;
+  std::map<int, std::string> expected;
+  std::mt19937 mt(11);
+  for (int i = 0; i < 2000; ++i) {
+    int key = static_cast<int>(mt() % 1000);
+    map[key] = std::to_string(i);
+    expected[key] = std::to_string(i);
+  }
+  Map<int, std::string> copy(map);
+  map.Clear();
+  ASSERT_EQ(copy.Size(), expected.size());
+  auto it = copy.Begin();
+  for (const auto& entry : expected) {
+    ASSERT_EQ(*it, entry);
+    ++it;
+  }
+  ASSERT_EQ(it, copy.End());
+  ASSERT_EQ(std::prev(copy.End())->first, expected.rbegin()->first);
+  ASSERT_EQ(copy.RBegin()->first, expected.rbegin()->first);
+
+  // Erases through every shape of node of the copied tree
+  for (int key = 0; key < 1000; key += 3) {
+    if (expected.erase(key) != 0) {
+      copy.Erase(key);
+    }
+  }
+  map[-1] = "-1";
+  map = copy;
+  const auto& same = map;
+  map = same;
+  copy.Clear();
+  ASSERT_EQ(map.Size(), expected.size());
+  auto rit = map.RBegin();
+  for (auto std_it = expected.rbegin(); std_it != expected.rend(); ++std_it) {
+    ASSERT_EQ(*rit, *std_it);
+    ++rit;
+  }
+  ASSERT_EQ(rit, map.REnd());
+
+  Map<int, std::string> empty;
+  map = empty;
+  ASSERT_EQ(map.Begin(), map.End());
+  map[1] = "1";
+  ASSERT_EQ(map.Begin()->second, "1");
+}
+
 
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);